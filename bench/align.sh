@@ -0,0 +1,54 @@
+#!/bin/sh
+# Compares JIT builds with different LOOP_ALIGN settings.
+#
+#   bench/align.sh [program.b...]
+#
+# Builds brainfuck-jit with LOOP_ALIGN=0, 16 and 32 in scratch copies of the tree, then
+# runs every program (bench/*.b by default) RUNS times on each build and prints the
+# median, minimum and maximum wall clock time in milliseconds. The builds are timed in
+# turns, so anything else going on in the machine hits all of them.
+#
+# Set ALIGNS to pick the settings, and RUNS for the number of runs.
+
+ALIGNS=${ALIGNS:-"0 16 32"}
+RUNS=${RUNS:-11}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+if [ $# -eq 0 ]; then
+    set -- "$ROOT"/bench/*.b
+fi
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT INT TERM
+
+for a in $ALIGNS; do
+    mkdir "$TMP/$a"
+    cp "$ROOT"/*.c "$ROOT"/*.h "$ROOT"/Makefile "$TMP/$a/"
+    make -s -C "$TMP/$a" LOOP_ALIGN="$a" brainfuck-jit || exit 1
+done
+
+now_ms() {
+    echo $(($(date +%s%N) / 1000000))
+}
+
+# Prints the median, minimum and maximum of the numbers on stdin.
+stats() {
+    sort -n | awk '{ t[NR] = $1 } END { printf "%8d %8d %8d", t[int((NR + 1) / 2)], t[1], t[NR] }'
+}
+
+printf '%-24s %6s %8s %8s %8s\n' program align median min max
+for prog in "$@"; do
+    name=$(basename "$prog")
+    for a in $ALIGNS; do
+        : > "$TMP/times.$a"
+    done
+    for i in $(seq "$RUNS"); do
+        for a in $ALIGNS; do
+            start=$(now_ms)
+            "$TMP/$a/brainfuck-jit" -O2 "$prog" < /dev/null > /dev/null
+            echo $(($(now_ms) - start)) >> "$TMP/times.$a"
+        done
+    done
+    for a in $ALIGNS; do
+        printf '%-24s %6s %s\n' "$name" "$a" "$(stats < "$TMP/times.$a")"
+    done
+done
@@ -0,0 +1,75 @@
+#!/bin/sh
+# Writes a big program that looks like generated code, for timing the compiler.
+#
+#   bench/bigprog.sh [megabytes [seed]] > big.b
+#
+# It is made of what compilers to Brainfuck emit: runs of moves and adds, clear loops,
+# copy loops and small counted loops nested up to 3 deep, all within 64 cells. The same
+# size and seed give the same program. It stops quickly if you run it, but it is only
+# meant to be compiled.
+
+MB=${1:-10}
+SEED=${2:-1}
+
+awk -v target="$((MB * 1000000))" -v seed="$SEED" '
+function rep(c, n,   s) {
+    s = ""
+    while (n-- > 0) {
+        s = s c
+    }
+    return s
+}
+
+function out(s) {
+    printf "%s", s
+    size += length(s)
+    col += length(s)
+    if (col >= 72) {
+        printf "\n"
+        size++
+        col = 0
+    }
+}
+
+function moveto(to) {
+    if (to > pos) {
+        out(rep(">", to - pos))
+    } else if (to < pos) {
+        out(rep("<", pos - to))
+    }
+    pos = to
+}
+
+# n random operations that stay at or above cell lo.
+function block(lo, depth, n,   i, r, k, at) {
+    for (i = 0; i < n; i++) {
+        r = rand()
+        if (r < 0.35) {
+            moveto(lo + int(rand() * (64 - lo)))
+        } else if (r < 0.7) {
+            out(rep(rand() < 0.5 ? "+" : "-", 1 + int(rand() * 12)))
+        } else if (r < 0.8) {
+            out("[-]")
+        } else if (r < 0.88 && pos + 3 < 64) {
+            k = 1 + int(rand() * 3)
+            out("[-" rep(">", k) "+" rep("<", k) "]")
+        } else if (r < 0.97 && depth < 3 && pos + 2 < 64) {
+            at = pos
+            out("[-]" rep("+", 1 + int(rand() * 4)) "[")
+            moveto(at + 1)
+            block(at + 1, depth + 1, 4 + int(rand() * 8))
+            moveto(at)
+            out("-]")
+        } else {
+            out(".")
+        }
+    }
+}
+
+BEGIN {
+    srand(seed)
+    while (size < target) {
+        block(0, 0, 100)
+    }
+    printf "\n"
+}'
@@ -0,0 +1,58 @@
+#!/bin/sh
+# Times the compiler on big generated programs.
+#
+#   bench/compile.sh [program.b...]        (or make bench-compile)
+#
+# Without arguments, bench/bigprog.sh writes programs of each of SIZES megabytes. Each
+# one is compiled RUNS times by brainfuck-jit -t and brainfuck-interp -t at each of OPTS,
+# and the table has the median time of each phase in milliseconds, the whole compile in
+# MB/s of source, and the peak RSS of the process in MiB. parse reads the source into IR,
+# optimize is everything done to the IR after that, and codegen is prepare_opcodes().
+
+SIZES=${SIZES:-"1 10 50"}
+BACKENDS=${BACKENDS:-"jit interp"}
+OPTS=${OPTS:-"0 1 2"}
+RUNS=${RUNS:-5}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+
+make -s -C "$ROOT" brainfuck-jit brainfuck-interp || exit 1
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT INT TERM
+
+if [ $# -eq 0 ]; then
+    for mb in $SIZES; do
+        sh "$ROOT/bench/bigprog.sh" "$mb" > "$TMP/big$mb.b" || exit 1
+        set -- "$@" "$TMP/big$mb.b"
+    done
+fi
+
+# Prints the median of the numbers on stdin.
+median() {
+    sort -n | awk '{ t[NR] = $1 } END { printf "%.2f", t[int((NR + 1) / 2)] }'
+}
+
+printf '%-16s %-7s %3s %9s %9s %9s %9s %9s %9s\n' program backend opt parse optimize codegen total MB/s 'RSS MiB'
+for prog in "$@"; do
+    name=$(basename "$prog" .b)
+    for b in $BACKENDS; do
+        for o in $OPTS; do
+            : > "$TMP/times"
+            for i in $(seq "$RUNS"); do
+                "$ROOT/brainfuck-$b" -t -O"$o" "$prog" > "$TMP/out" || break
+                awk '$1 == "source" { len = $2 } $1 == "parse" { p = $2 } $1 == "optimize" { o = $2 }
+                    $1 == "codegen" { c = $2 } $1 == "total" { t = $2 } $1 == "peak" { r = $3 }
+                    END { print p, o, c, t, len / 1000 / t, r / 1024 }' "$TMP/out" >> "$TMP/times"
+            done
+            if [ "$(wc -l < "$TMP/times")" -ne "$RUNS" ]; then
+                printf '%-16s %-7s %3s %s\n' "$name" "$b" "$o" "failed to compile"
+                continue
+            fi
+            printf '%-16s %-7s %3s' "$name" "$b" "$o"
+            for col in 1 2 3 4 5 6; do
+                printf ' %9s' "$(awk -v c="$col" '{ print $c }' "$TMP/times" | median)"
+            done
+            printf '\n'
+        done
+    done
+done
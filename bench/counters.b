@@ -0,0 +1,7 @@
+Nested counters: 8 * 255 * 255 * 255 trips through a small inner loop
+The inner loops decrement last so they are not turned into multiply loops
+
+++++++++
+[>-[>-[>-[>+>++>+++<<<-]<-]<-]<-]
+>>>>.>.>.
+>++++++++++.
@@ -0,0 +1,201 @@
+Factors the decimal number on each line of its input up to 65535
+Trial division by every number up to the square root with 16 bit numbers
+in two 8 bit cells
+
+>>>>>>>>>>>>>>,+[-[->>>>>>+>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<----------<<<<[
+-]+>>>>[->+>+<<]>>[-<<+>>]<[[-]<<<<<[-]>>>>>]<[-]<<<<[->>>>+>>+<<<<<<]>>>>>>[-
+<<<<<<+>>>>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>>>>
+>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-<<<<<<<<<<<<+>
++<[>-]>[>]<[-<<+>>]>>>>>>>>>>>]<<<[-]++++++++++<<<<<<<<<[->>>+>>>>>>->+<[>-]>[
+>]<[-<[-]++++++++++<<<<<<[-]>>>>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]<<<<<<<<<<]<[-
+>>>>+>>>>>>->+<[>-]>[>]<[-<[-]++++++++++<<<<<<[-]>>>>>>>>>>+>+<[>-]>[>]<[-<<+>
+>]<<<<]>>>>>>-[<<<<<<<<<<<<<+>>>>>>->+<[>-]>[>]<[-<[-]++++++++++<<<<<<[-]>>>>>
+>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-]<<<<<<<<<<<<<<<<<]>>>>>>>>>>[-]>>>[-<<<
+<<<<<<<<<<+>>>>>>>>>>>>>]>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<<<<[-]++++++++++<<<<<
+<<<<[->>>>+>>>>>->+<[>-]>[>]<[-<[-]++++++++++<<<<<[-]>>>>>>>>>+>+<[>-]>[>]<[-<
+<+>>]<<<<]<<<<<<<<<<]<[->>>>>+>>>>>->+<[>-]>[>]<[-<[-]++++++++++<<<<<[-]>>>>>>
+>>>+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-[<<<<<<<<<<<<+>>>>>->+<[>-]>[>]<[-<[-]++++
+++++++<<<<<[-]>>>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-]<<<<<<<<<<<<<<<<<]>>>
+>>>>>>>[-]>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<<<<
+[-]++++++++++<<<<<<<<<[->>>>>+>>>>->+<[>-]>[>]<[-<[-]++++++++++<<<<[-]>>>>>>>>
++>+<[>-]>[>]<[-<<+>>]<<<<]<<<<<<<<<<]<[->>>>>>+>>>>->+<[>-]>[>]<[-<[-]++++++++
+++<<<<[-]>>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-[<<<<<<<<<<<+>>>>->+<[>-]>[>
+]<[-<[-]++++++++++<<<<[-]>>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-]<<<<<<<<<<<
+<<<<<<]>>>>>>>>>>[-]>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]>[-<<<<<<<<<<<<<+>>>>>>>>
+>>>>>]<<<<[-]++++++++++<<<<<<<<<[->>>>>>+>>>->+<[>-]>[>]<[-<[-]++++++++++<<<[-
+]>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]<<<<<<<<<<]<[->>>>>>>+>>>->+<[>-]>[>]<[-<[-]
+++++++++++<<<[-]>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-[<<<<<<<<<<+>>>->+<[>-
+]>[>]<[-<[-]++++++++++<<<[-]>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-]<<<<<<<<<
+<<<<<<<<]>>>>>>>>>>[-]>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]>[-<<<<<<<<<<<<<+>>>>>>
+>>>>>>>]<<<<[-]++++++++++<<<<<<<<<[->>>>>>>+>>->+<[>-]>[>]<[-<[-]++++++++++<<[
+-]>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]<<<<<<<<<<]<[->>>>>>>>+>>->+<[>-]>[>]<[-<[-]
+++++++++++<<[-]>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-[<<<<<<<<<+>>->+<[>-]>[>
+]<[-<[-]++++++++++<<[-]>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-]<<<<<<<<<<<<<<<
+<<]>>>>>>>>>>[-]>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]>[-<<<<<<<<<<<<<+>>>>>>>>>>>>
+>]<<<<<<[->>>>>+>+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]<[[-]<<<<[-]+>>>>]<<<<[->>>>+>+
+<<<<<]>>>>>[-<<<<<+>>>>>]<[[-]<<<<<+++++++++++++++++++++++++++++++++++++++++++
++++++.>>>>>]<<<<<[-]<[->>>>>>+>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<[[-]<<<<[-]+
+>>>>]<<<<[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[[-]<<<<<<++++++++++++++++++++++++
+++++++++++++++++++++++++.>>>>>>]<<<<<<[-]<[->>>>>>>+>+<<<<<<<<]>>>>>>>>[-<<<<<
+<<<+>>>>>>>>]<[[-]<<<<[-]+>>>>]<<<<[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[[-]<<<<
+<<<++++++++++++++++++++++++++++++++++++++++++++++++.>>>>>>>]<<<<<<<[-]<[->>>>>
+>>>+>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]<[[-]<<<<[-]+>>>>]<<<<[->>>>+>+
+<<<<<]>>>>>[-<<<<<+>>>>>]<[[-]<<<<<<<<++++++++++++++++++++++++++++++++++++++++
+++++++++.>>>>>>>>]<<<<<<<<[-]>>>>[-]+[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[[-]<<
+<<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++.>>>>>>>>>]<<<<<<<<<[-]
+>>>>>[-]<<<<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++++++++++++.[-
+]<<<<<<<<<<[-]++>>>[-]<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<
+<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>
+>>>>>>>>>]<[[-]<<<<<<<<[-]+>>>>>>>>][-]+[->+>>>>+<<<<<]>>>>>[-<<<<<+>>>>>]<<<<
+<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<
+<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>
+>>>>>>>>>>]<<<<<<[-]>>>>>[-<<+<[>-]>[>]<[-<<<[-]+>>>>>[-]<<<+>]<->>>]<<<[-]<[-
+]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<[-]+>>>>>>>>]<[-]<<<<<<<[<<<<<<<<<<<[-]>[-]>
+>>>>>>>[-]>>>>[-]<<<<<[->>>>>+>>>>>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>
+>>]<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>+>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<]>>>>
+>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<
+<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>
+>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>]<[-<<<<<<<<<<<<<+>+<[>-]>[>]
+<[-<<+>>]>>>>>>>>>>>>]<<<<<<<<<<<<<[->>>>+>>>>->+<[>-]>[>]<[-<<<<<<[->>>>>+>>>
+>>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<<<<<<<<<[-]<<<<<<<<+>+<[>-]>[
+>]<[-<<+>>]>>>>>>>>>>>>]<<<<<<<<<]<[->>>>>+>>>>->+<[>-]>[>]<[-<<<<<<[->>>>>+>>
+>>>>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<<<<<<<<<<[-]<<<<<<<<+>+
+<[>-]>[>]<[-<<+>>]>>>>>>>>>>>>]>>>>-[<<<<<<<<<+>>>>->+<[>-]>[>]<[-<<<<<<[->>>>
+>+>>>>>>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<<<<<<<<<<[-]<<<<<<<
+<+>+<[>-]>[>]<[-<<+>>]>>>>>>>>>>>>]>>>>-]<<<<<<<<<<<<<<]>>>>>>>>>[-]<<<<[->>>>
+>>>>>+>>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<[-]+<[[-]>[-]>>[-]+
+<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>
+>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<[-]>]
+<[[-]<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<<<<<<<<<<<<<<<<<<<
+<]>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>
+>>]<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>
+>>[-<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>]<<<<<<[-]>>>>>[-<<+<[>-]>[>]<[-<<<[-
+]+>>>>>[-]<<<+>]<->>>]<<<[-]<]<[->+>>+<<<]>>>[-<<<+>>>]<[-]+<[[-]>[-]<<<<<<<<<
+<<[-]>>>>>>>>>>]>[[-]<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>[-]+<<<<<<<<<<<<<<<[->>>>>>
+>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<+>>>>>>>>>>
+>>>>>>>]<[[-]<[-]>]<[[-]<<<<<<<<<<<<[-]>>>>>>>>>>>>]<]<<[-]<<<<<<<<<<<<<<<<<<<
+<[-]>[-]>>>>>>>>>>>>>>>>>]>[[-]>++++++++++++++++++++++++++++++++.[-]<<<<<<<<<<
+<<[->>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<<<
+<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<[-]>[-]>>>>[-]++++++++++>>>[-<<
+<<<<<+>>>>->+<[>-]>[>]<[-<[-]++++++++++<<<<[-]<+>>>>>>]>>]<<<[-]<<<<<[->>>>>>>
+>+>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]<<<<<<<[-]>[-]>>[-]++++++++++>>>[
+-<<<<<+>>->+<[>-]>[>]<[-<[-]++++++++++<<[-]<+>>>>]>>]<<<[-]<<<[->>>+>+<<<<]>>>
+>[-<<<<+>>>>]<[[-]<<<++++++++++++++++++++++++++++++++++++++++++++++++.[-]>>[-]
++>]<<<<<[->>>>>+>+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]<[[-]<[-]+>]<[->+>+<<]>>[-<<+>>
+]<[[-]<<++++++++++++++++++++++++++++++++++++++++++++++++.>>]<<[-]>[-]<<<<[-]>+
++++++++++++++++++++++++++++++++++++++++++++++++.[-]<<<<<<<<<<<<<<<<<<<<<<<<<[-
+]>[-]>>>[-<<<<+>>>>]>[-<<<<+>>>>]>>>>>>>>>>>[-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>
+>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<
+<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<[-]+>>>>>>>>>][-]+
+[->+>>>>+<<<<<]>>>>>[-<<<<<+>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>
+>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[
+-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<[-]>>>>>[-<
+<+<[>-]>[>]<[-<<<[-]+>>>>>[-]<<<+>]<->>>]<<<[-]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<
+<<<<<<<[-]+>>>>>>>>>]<[-][-]+<<<<<<<<[->>>>>>>>>+>+<<<<<<<<<<]>>>>>>>>>>[-<<<<
+<<<<<<+>>>>>>>>>>]<[[-]<[-]>]<[[-]<<<<<<<<<[-]>>>>>>>>>]<<<<<<<<[-]>>>>>>>]<<<
+<<<<<<<[-]>>]>[-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<
+<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>
+>>>>>]<[[-]<<<<<<<[-]+>>>>>>>][-]+[->+>>>>+<<<<<]>>>>>[-<<<<<+>>>>>]<<<<<<<<<<
+<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>
+>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>
+>>>>]<<<<<<[-]>>>>>[-<<+<[>-]>[>]<[-<<<[-]+>>>>>[-]<<<+>]<->>>]<<<[-]<[-]<[->+
+>+<<]>>[-<<+>>]<[[-]<<<<<<<[-]+>>>>>>>]<[-]<<<<<<[->>>>>>+>+<<<<<<<]>>>>>>>[-<
+<<<<<<+>>>>>>>]<[[-]>++++++++++++++++++++++++++++++++.[-]<<<<<<<<<<<<<<<<<<<<<
+<<[->>>>>>>>>>>>>>>>>>>>>>>+>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>]<[-<<<<<<<<<<<<+>+<[>-]>[>]<[-<<+>>]>>>>>>>>>>>]<<<[-
+]++++++++++<<<<<<<<<[->>>+>>>>>>->+<[>-]>[>]<[-<[-]++++++++++<<<<<<[-]>>>>>>>>
+>>+>+<[>-]>[>]<[-<<+>>]<<<<]<<<<<<<<<<]<[->>>>+>>>>>>->+<[>-]>[>]<[-<[-]++++++
+++++<<<<<<[-]>>>>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-[<<<<<<<<<<<<<+>>>>>>-
+>+<[>-]>[>]<[-<[-]++++++++++<<<<<<[-]>>>>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>
+>-]<<<<<<<<<<<<<<<<<]>>>>>>>>>>[-]>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]>[-<<<<<<<<
+<<<<<+>>>>>>>>>>>>>]<<<<[-]++++++++++<<<<<<<<<[->>>>+>>>>>->+<[>-]>[>]<[-<[-]+
++++++++++<<<<<[-]>>>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]<<<<<<<<<<]<[->>>>>+>>>>>-
+>+<[>-]>[>]<[-<[-]++++++++++<<<<<[-]>>>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-
+[<<<<<<<<<<<<+>>>>>->+<[>-]>[>]<[-<[-]++++++++++<<<<<[-]>>>>>>>>>+>+<[>-]>[>]<
+[-<<+>>]<<<<]>>>>>>-]<<<<<<<<<<<<<<<<<]>>>>>>>>>>[-]>>>[-<<<<<<<<<<<<<+>>>>>>>
+>>>>>>]>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<<<<[-]++++++++++<<<<<<<<<[->>>>>+>>>>->
++<[>-]>[>]<[-<[-]++++++++++<<<<[-]>>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]<<<<<<<<<<
+]<[->>>>>>+>>>>->+<[>-]>[>]<[-<[-]++++++++++<<<<[-]>>>>>>>>+>+<[>-]>[>]<[-<<+>
+>]<<<<]>>>>>>-[<<<<<<<<<<<+>>>>->+<[>-]>[>]<[-<[-]++++++++++<<<<[-]>>>>>>>>+>+
+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-]<<<<<<<<<<<<<<<<<]>>>>>>>>>>[-]>>>[-<<<<<<<<<<<
+<<+>>>>>>>>>>>>>]>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<<<<[-]++++++++++<<<<<<<<<[->>
+>>>>+>>>->+<[>-]>[>]<[-<[-]++++++++++<<<[-]>>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]<<
+<<<<<<<<]<[->>>>>>>+>>>->+<[>-]>[>]<[-<[-]++++++++++<<<[-]>>>>>>>+>+<[>-]>[>]<
+[-<<+>>]<<<<]>>>>>>-[<<<<<<<<<<+>>>->+<[>-]>[>]<[-<[-]++++++++++<<<[-]>>>>>>>+
+>+<[>-]>[>]<[-<<+>>]<<<<]>>>>>>-]<<<<<<<<<<<<<<<<<]>>>>>>>>>>[-]>>>[-<<<<<<<<<
+<<<<+>>>>>>>>>>>>>]>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<<<<[-]++++++++++<<<<<<<<<[-
+>>>>>>>+>>->+<[>-]>[>]<[-<[-]++++++++++<<[-]>>>>>>+>+<[>-]>[>]<[-<<+>>]<<<<]<<
+<<<<<<<<]<[->>>>>>>>+>>->+<[>-]>[>]<[-<[-]++++++++++<<[-]>>>>>>+>+<[>-]>[>]<[-
+<<+>>]<<<<]>>>>>>-[<<<<<<<<<+>>->+<[>-]>[>]<[-<[-]++++++++++<<[-]>>>>>>+>+<[>-
+]>[>]<[-<<+>>]<<<<]>>>>>>-]<<<<<<<<<<<<<<<<<]>>>>>>>>>>[-]>>>[-<<<<<<<<<<<<<+>
+>>>>>>>>>>>>]>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<<<<<<[->>>>>+>+<<<<<<]>>>>>>[-<<<
+<<<+>>>>>>]<[[-]<<<<[-]+>>>>]<<<<[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[[-]<<<<<+
++++++++++++++++++++++++++++++++++++++++++++++++.>>>>>]<<<<<[-]<[->>>>>>+>+<<<<
+<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<[[-]<<<<[-]+>>>>]<<<<[->>>>+>+<<<<<]>>>>>[-<<<<<
++>>>>>]<[[-]<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++.>>>>>>]<<<<
+<<[-]<[->>>>>>>+>+<<<<<<<<]>>>>>>>>[-<<<<<<<<+>>>>>>>>]<[[-]<<<<[-]+>>>>]<<<<[
+->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[[-]<<<<<<<+++++++++++++++++++++++++++++++++
++++++++++++++++.>>>>>>>]<<<<<<<[-]<[->>>>>>>>+>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<
++>>>>>>>>>]<[[-]<<<<[-]+>>>>]<<<<[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[[-]<<<<<<
+<<++++++++++++++++++++++++++++++++++++++++++++++++.>>>>>>>>]<<<<<<<<[-]>>>>[-]
++[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[[-]<<<<<<<<<+++++++++++++++++++++++++++++
++++++++++++++++++++.>>>>>>>>>]<<<<<<<<<[-]>>>>>[-]<<<<<<<<<<]<<<<<<[-]>>>>>>++
+++++++++.[-]<<<<<<<<<<<<<<<<<<<<<<[-]>[-]>>>>>>>>>>>>>>>>>>>]>[[-]<<<<<<<<<<<<
+<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>
+>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<
+<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>
+>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]
+<[-<<<+>+<[>-]>[>]<[-<<+>>]>>]<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>
+>>+>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<
+<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>
+>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<
+<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-<<<+>+<[>-]>[>]<[-<<+>>]>>]<
+<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<<<<<<<<<<<<<<<<<<
+<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>
+>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<
+<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>
+>>>>>>>>>>>>>>>]<[-<<<+>+<[>-]>[>]<[-<<+>>]>>]<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>
+>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[
+-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<
+<<[->>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>
+>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-<<<+>+<[>-]>
+[>]<[-<<+>>]>>]<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<<
+<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>
+>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>+>
++<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<
+<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-<<<+>+<[>-]>[>]<[-<<+>>]>>]<<<<<<<<<<<<<<<<
+<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>
+>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<
+<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>
+>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>
+]<[-<<<+>+<[>-]>[>]<[-<<+>>]>>]<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>
+>>>+>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<
+<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>
+>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<
+<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-<<<+>+<[>-]>[>]<[-<<+>>]>>]
+<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<<<<<<<<<<<<<<<<<
+<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>
+>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<
+<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>
+>>>>>>>>>>>>>>>>]<[-<<<+>+<[>-]>[>]<[-<<+>>]>>]<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>
+>>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>
+[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<
+<<<[->>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>
+>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-<<<+>+<[>-]
+>[>]<[-<<+>>]>>]<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<
+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>
+>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>+
+>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<
+<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-<<<+>+<[>-]>[>]<[-<<+>>]>>]<<<<<<<<<<<<<<<
+<<<<<<<<<<<[-]>[-]>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>
+>>>>>>>>]>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<-----------
+-------------------------------------[-<<<<<<<<<<<<<+>+<[>-]>[>]<[-<<+>>]>>>>>
+>>>>>>>]>>>>>>>]<<<<<[-]<<[-],+]
@@ -0,0 +1,263 @@
+Towers of Hanoi with 16 disks: prints all 65535 moves as two peg letters
+A binary counter picks the disk to move next and each disk cycles through
+the pegs in a fixed direction
+
+[-]+[>[-]+[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>]>[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]+<[-]>>>>
+>>>>>>>>>>>>>[->>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>
+[-<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>]<+++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++++.[-]<<<<<<<<<<<<<<<<<<<+[->>>>>>>>>>>>>>>>>>>>
+>+>+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>
+>>>>>>>>>>>>>>>>>>]<---<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[
+-<<+>>]<[[-]<<<<<<<<<<<<<<<<<<<<<--->>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<
+<[->>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>[-<<<<
+<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>]<----<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<
+<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<<<<<<<<--->>>>>>>>>>>>>>>>>>
+>>>]<[-]<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<]>>>>>
+>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>]<++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++.[-]++++++++++.[-]<]<<]<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-
+]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]>[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]+<<
+[-]>>>>>>>>>>>>>>>>>>[->>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>
+>>>>>[-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>]<++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++.[-]<<<<<<<<<<<<<<<<<<++[->>>>>>>>>>>>>>>>>
+>>>+>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<+>>>>>
+>>>>>>>>>>>>>>>>]<---<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<
+<+>>]<[[-]<<<<<<<<<<<<<<<<<<<<--->>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<[->>
+>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<
+<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>]<----<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-
+]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<<<<<<<--->>>>>>>>>>>>>>>>>>>>]<[-]<<<<
+<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>[
+-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>]<++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++.[-]++++++++++.[-]<]<<]<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>]>[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]+<<<[-]>>>>>>>>>>>>>>>>>>>[->>
+>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<+>>
+>>>>>>>>>>>>>>>>]<++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++.[-]<<<<<<<<<<<<<<<<<+[->>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<]>>>>>>
+>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>]<---<[-]+>[->+>+<<]>
+>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<<<<<<--->>>>>
+>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<
+]>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>]<----<[-]+>[-
+>+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<<<<<<
+--->>>>>>>>>>>>>>>>>>>]<[-]<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<
+<<<<<<<]>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>]<+++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++.[-]++++++++++.[-]<]<<]<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>]>[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]+<<<<[-]>>>>>>
+>>>>>>>>>>>>>>[->>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>[-<<<<<<
+<<<<<<<<<<<+>>>>>>>>>>>>>>>>>]<+++++++++++++++++++++++++++++++++++++++++++++++
+++++++++++++++++++.[-]<<<<<<<<<<<<<<<<++[->>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<
+<<<<]>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>]<---<[-]+>[-
+>+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<<<<<-
+-->>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<
+<<<]>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>]<----<[-]+>[-
+>+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<<<<<-
+-->>>>>>>>>>>>>>>>>>]<[-]<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<
+<<]>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>]<+++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++.[-]++++++++++.[-]<]<<]<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>]>[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]+<<<<<[-]>>>>>>>>>>>>>>>>>>>>>[
+->>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>
+>>>>>>>>>]<+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++.[
+-]<<<<<<<<<<<<<<<+[->>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>[
+-<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>]<---<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]
+>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<<<<--->>>>>>>>>>>>>>>>>]<<<<<<<<
+<<<<<<<<<[->>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>[-<<<<<<<<
+<<<<<<<<<<+>>>>>>>>>>>>>>>>>>]<----<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<
+[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<<<<--->>>>>>>>>>>>>>>>>]<[-]<<<<<<<<<<<<
+<<<<[->>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>
+>>>>>>>>>>>>>>]<++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++.[-]++++++++++.[-]<]<<]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>]<[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>>>>>]>[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]+<<<<
+<<[-]>>>>>>>>>>>>>>>>>>>>>>[->>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>[
+-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>]<++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++.[-]<<<<<<<<<<<<<<++[->>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<
+<]>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>]<---<[-]+>[->+>+<<]>>
+[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<<<--->>>>>>>>>
+>>>>>>>]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>
+>>[-<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>]<----<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[
+-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<<<--->>>>>>>>>>>>>>>>]<[-]<<<<
+<<<<<<<<<<<[->>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<
++>>>>>>>>>>>>>>>]<++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++.[-]++++++++++.[-]<]<<]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>]<[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<[
+-]>>>>>>>>>>>>>>>>>>>>>>>>>>>]>[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]+<<<<<<<[-]>
+>>>>>>>>>>>>>>>>>>>>>>[->>>>>>>>>>>>>+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<
+<<<<<<<+>>>>>>>>>>>>>>]<++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++.[-]<<<<<<<<<<<<<+[->>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>
+>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]<---<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-
+]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<<--->>>>>>>>>>>>>>>]<<<<<<<<<<<
+<<<<[->>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>
+>>>>>>>>>>>>>>]<----<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<
++>>]<[[-]<<<<<<<<<<<<<<<--->>>>>>>>>>>>>>>]<[-]<<<<<<<<<<<<<<[->>>>>>>>>>>>>+>
++<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<+++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++.[-]++++++++++.[-]<]<<]<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<<<<<<<<<<<<<
+<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-]
++<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>>>]>[[-]<<<<<<
+<<<<<<<<<<<<<<<<<<<<<[-]+<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>[->>>>>>>>>>>>+>+<
+<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<+++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++.[-]<<<<<<<<<<<<++[->>>>>>>>>>>>>>
++>+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>]<---<[-]+>
+[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<---
+>>>>>>>>>>>>>>]<<<<<<<<<<<<<<[->>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>
+>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>]<----<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]
+<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<--->>>>>>>>>>>>>>]<[-]<<<<<<<<<<<<<
+[->>>>>>>>>>>>+>+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<+++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++.[-]++++++++++.[
+-]<]<<]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<
+<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>
+>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>
+>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>>]>[[-]<<
+<<<<<<<<<<<<<<<<<<<<<<<<[-]+<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>>[->>>>>>>>>>>
++>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<+++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++.[-]<<<<<<<<<<<+[->>>>>>>>>>>>>+>+
+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<---<[-]+>[->+>+<
+<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<--->>>>>>>>
+>>>>>]<<<<<<<<<<<<<[->>>>>>>>>>>>>+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<
+<<<<+>>>>>>>>>>>>>>]<----<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>
+>[-<<+>>]<[[-]<<<<<<<<<<<<<--->>>>>>>>>>>>>]<[-]<<<<<<<<<<<<[->>>>>>>>>>>+>+<<
+<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++.[-]++++++++++.[-]<]<<]<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>
+>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<
+<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<
+<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>]>[[-]<<<<<<<<<<<<<<<<<<<<<<<<<[-]+<<<<
+<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>>>[->>>>>>>>>>+>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<
+<<<<<<<<+>>>>>>>>>>>]<++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++.[-]<<<<<<<<<<++[->>>>>>>>>>>>+>+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<<<
+<<<<<<+>>>>>>>>>>>>>]<---<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>
+>[-<<+>>]<[[-]<<<<<<<<<<<<--->>>>>>>>>>>>]<<<<<<<<<<<<[->>>>>>>>>>>>+>+<<<<<<<
+<<<<<<]>>>>>>>>>>>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<----<[-]+>[->+>+<<]>>[-<<+>
+>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<--->>>>>>>>>>>>]<[-]<<
+<<<<<<<<<[->>>>>>>>>>+>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<++++
++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++.[-]++++++++++.[-
+]<]<<]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<<
+<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>
+>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>]<[-]+<[[-]>
+[-]<<<<<<<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>]>[[-]<<<<<<<<<<<<<<<<<<<
+<<<<<[-]+<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>>>>[->>>>>>>>>+>+<<<<<<<<<<]>>>
+>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++.[-]<<<<<<<<<+[->>>>>>>>>>>+>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<
+<<<<<<<<<<+>>>>>>>>>>>>]<---<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<
+<]>>[-<<+>>]<[[-]<<<<<<<<<<<--->>>>>>>>>>>]<<<<<<<<<<<[->>>>>>>>>>>+>+<<<<<<<<
+<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<----<[-]+>[->+>+<<]>>[-<<+>>]<[[
+-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<--->>>>>>>>>>>]<[-]<<<<<<<<<
+<[->>>>>>>>>+>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<+++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++.[-]++++++++++.[-]<]<<]<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<<<<<<<<<<<<[->
+>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>[-<<
+<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<
+<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>]>[[-]<<<<<<<<<<<<<<<<<<<<<<<[-]+<<<<<<<<<<<<[
+-]>>>>>>>>>>>>>>>>>>>>>>>>>>>>[->>>>>>>>+>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>
+>>>>>]<+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++.[-]<<
+<<<<<<++[->>>>>>>>>>+>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<---<[
+-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<---
+>>>>>>>>>>]<<<<<<<<<<[->>>>>>>>>>+>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>
+>>>>>>]<----<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-
+]<<<<<<<<<<--->>>>>>>>>>]<[-]<<<<<<<<<[->>>>>>>>+>+<<<<<<<<<]>>>>>>>>>[-<<<<<<
+<<<+>>>>>>>>>]<+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+++.[-]++++++++++.[-]<]<<]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>]<[[-]<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<
+]>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>]<[-]
++<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>]>[[-]<<<<<<<<<<<<<<<<
+<<<<<<[-]+<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[->>>>>>>+>+<<<<<<<<]>>
+>>>>>>[-<<<<<<<<+>>>>>>>>]<+++++++++++++++++++++++++++++++++++++++++++++++++++
+++++++++++++++.[-]<<<<<<<+[->>>>>>>>>+>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>
+>>>>>>]<---<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]
+<<<<<<<<<--->>>>>>>>>]<<<<<<<<<[->>>>>>>>>+>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<
++>>>>>>>>>>]<----<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>
+]<[[-]<<<<<<<<<--->>>>>>>>>]<[-]<<<<<<<<[->>>>>>>+>+<<<<<<<<]>>>>>>>>[-<<<<<<<
+<+>>>>>>>>]<+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++.
+[-]++++++++++.[-]<]<<]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]
+<[[-]<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<]>>>>>
+>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>]<[-]+<[[-]>[-
+]<<<<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>]>[[-]<<<<<<<<<<<<<<<<<<<<<[-]+<<
+<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[->>>>>>+>+<<<<<<<]>>>>>>>[-<<<<<
+<<+>>>>>>>]<+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++.
+[-]<<<<<<++[->>>>>>>>+>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]<---<[-]+>[->
++>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<--->>>>>>>>]
+<<<<<<<<[->>>>>>>>+>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]<----<[-]+>[->+>
++<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<--->>>>>>>>]<[
+-]<<<<<<<[->>>>>>+>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++.[-]++++++++++.[-]<]<<]<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>
+>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<
++>>>>>>>>>>>>>>>>>>>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>
+>]>[[-]<<<<<<<<<<<<<<<<<<<<[-]+<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>[->>>>>+>+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]<++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++.[-]<<<<<+[->>>>>>>+>+<<<<<<<<]>>>>>>>>[-<<<<<<<<
++>>>>>>>>]<---<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[
+[-]<<<<<<<--->>>>>>>]<<<<<<<[->>>>>>>+>+<<<<<<<<]>>>>>>>>[-<<<<<<<<+>>>>>>>>]<
+----<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<
+--->>>>>>>]<[-]<<<<<<[->>>>>+>+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]<+++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++.[-]++++++++++.[-]<]<<]<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<<<<<<<<[->>>>>
+>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<
+<<+>>>>>>>>>>>>>>>>>>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>
+]>[[-]<<<<<<<<<<<<<<<<<<<[-]+<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<+++++++++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++.[-]<<<<++[->>>>>>+>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]
+<---<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<-
+-->>>>>>]<<<<<<[->>>>>>+>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<----<[-]+>[->+>+<<
+]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>]<[[-]<<<<<<--->>>>>>]<[-]<<<<<
+[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<+++++++++++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++.[-]++++++++++.[-]<]<<]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>]<[[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]<]
@@ -0,0 +1,204 @@
+Mandelbrot set: 40 by 21 characters with up to 64 iterations per point
+Fixed point with 4 fraction bits in sign and magnitude cell pairs so the
+math fits in 8 bit cells
+
+>>>>>>>>[-]+++++++++++++++++++++<<<<<<<<[-]+>[-]++++++++++++++++++++>>>>>>>[>[
+-]++++++++++++++++++++++++++++++++++++++++<<<<<<<[-]+>[-]+++++++++++++++++++++
++++++++++++>>>>>>[<<<<<[-]>[-]>[-]>[-]>>>[-]++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++>[-]+[>[-]>>>>>>>>>>[-]+++++++++++++++++++++++++
++++++++[->+>>>>+<<<<<]>>>>>[-<<<<<+>>>>>]<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>
+>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<
+<<+>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>[-<<+<[>-]>[>]<[-<<<<<
+<<<<<<[-]+>>>>>>>>>>>>>[-]<<<+>]<->>>]<<<[-]<[-]<<<<<<<<<[->>>>>>>>>+>+<<<<<<<
+<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<[[-]<<<<<<<<<<[-]+>>>>>>>>>>][-]+++++++
++++++++++++++++++++++++++[->+>>>>+<<<<<]>>>>>[-<<<<<+>>>>>]<<<<<<<<<<<<<<<<<<<
+<[->>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<
+<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>[-<<+<[>-]>[>]<[
+-<<<<<<<<<<<[-]+>>>>>>>>>>>>>[-]<<<+>]<->>>]<<<[-]<[-]<<<<<<<<<[->>>>>>>>>+>+<
+<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<[[-]<<<<<<<<<<[-]+>>>>>>>>>>]<<<<
+<<<<<[-]>>>>>>>>>[-]+<<<<<<<<<<[->>>>>>>>>>>+>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<
+<<<<<<<<+>>>>>>>>>>>>]<[[-]<[-]>]<[[-]>[-]++++++++++++++++<<<<<<<<<[-]<<<<<<<<
+<[->>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>[-<
+<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>]<<[-<<<<<<<<<<<<<<<<<<<<<[->>>>
+>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<
+<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>]<[-<<<<->+<[>-]>[>]<[-<[-]++++++++++++
+++++<<<<<<<<<+>>>>>>>>>>]>>>]<]<<<[-][-]++++++++++++++++<<<<<<<<[-]<<<<<<<<[->
+>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<
+<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>]<<[-<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>
++>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>
+>>>>>>>>>>>>>]<[-<<<<->+<[>-]>[>]<[-<[-]++++++++++++++++<<<<<<<<+>>>>>>>>>]>>>
+]<]<<<[-]<<<<<<<<<[->>>>>>>>>+>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<
+<<<<<<<<[->>>>>>>>+>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>][-]+++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++++++++[->+>>>>+<<<<<]>>>>>[-<<<<<
++>>>>>]<<<<<<[->>>>>+>+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]<<<<<<<<<<<<<<<<[-]>>>>>>>
+>>>>>>>>[-<<+<[>-]>[>]<[-<<<<<<<<<<<<<[-]+>>>>>>>>>>>>>>>[-]<<<+>]<->>>]<<<[-]
+<[-]<[-]<<<<<<<<<<[->>>>>>>>>>+>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>
+>>>]<[[-]<<<<<<<<<<<[-]+>>>>>>>>>>>]<<<<<<<<<<[-]>>>>>>>>>>[-]+<<<<<<<<<<<[->>
+>>>>>>>>>>+>+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<[[-]<[-
+]>]<[[-]>[-]++++++++++++++++<<<<<<<<[-]<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>>+
+<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<+>>
+>>>>>>>>>>>>>>>>>>>>>>]<<[-<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>+>+<<<<<
+<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>
+>>>>>>>>>]<[-<<<<->+<[>-]>[>]<[-<[-]++++++++++++++++<<<<<<<<+>>>>>>>>>]>>>]<]<
+<<[-]<<<<<<<<[->>>>>>>>++<<<<<<<<]>>>>>>>>[-<<<<<<<<+>>>>>>>>]<<<<<<<<<<<<<<<<
+<<<<[->>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<
+<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>
+>+>+<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>
+>>>>>>]<[->+>+<<]>>[-<<+>>]<-<<<<<<<<[-]+>>>>>>>>[->+>+<<]>>[-<<+>>]<[[-]<<<<<
+<<<<[-]>>>>>>>>>]<[-]<[-]<<<<<<<<<<[->>>>>>>>>>>+>>>>+<<<<<<<<<<<<<<<]>>>>>>>>
+>>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<[->>>>>>>>>>>>>+>+<<<<<
+<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<<<<<[-]>>>>[-<<+<[>-]
+>[>]<[-<<[-]+>>>>[-]<<<+>]<->>>]<<<[-]<[->+>>+<<<]>>>[-<<<+>>>]<[-]+<[[-]>[-]<
+<<<<<<<[-]+<<<[->>>>+>>>>>>>>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>
+>>>>]<<<<<<<<<<<<<[->>>>>->>>>>>>>+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<<<<<<<<<+
+>>>>>>>>>>>>>]<<]>[[-]<<<<<<<<[-]<<<<[->>>>>+>>>>>>>>+<<<<<<<<<<<<<]>>>>>>>>>>
+>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<<<<<<<<<<<<[->>>>->>>>>>>>+<<<<<<<<<<<<]>>>>
+>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<]<<[-]<<<<[-]>[-]<<<[->>>>>>+>>+<<<<<<<<]
+>>>>>>>>[-<<<<<<<<+>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>
+>+<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<+
+>>>>>>>>>>>>>>>>>>>>>>>>]<<[->>+>+<<<]>>>[-<<<+>>>]<-<[-]+>[->+>+<<]>>[-<<+>>]
+<[[-]<<[-]>>]<[-]<<[-]>[->+>>+<<<]>>>[-<<<+>>>]<[-]+<[[-]>[-]<<<<<<<<[->>>>>>>
+>>>+>>>>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<[-]>>>>[-<<+<[>-]>[>]<[-<<[-]+>>>>[-]<<<+>]<->>>
+]<<<[-]<[->+>>+<<<]>>>[-<<<+>>>]<[-]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>
+>>>>>>>>>>>>>>>>+>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>+>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>]<<<<<<<<<<<<[->>->>>>>>>>>>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<
+<<<<+>>>>>>>>>>>>]<<]>[[-]<<<<<<<<<<<<[->>+>>>>>>>>>>>+<<<<<<<<<<<<<]>>>>>>>>>
+>>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]<<<<<<<<<<<<[->>+>>>>>>>>>>+<<<<<<<<<<<<]>>>
+>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>
+>>>>>>>->>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<]<<[-]<<]>[[-]<<<<<
+<<<<[->>+>>>>>>>>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<<<<<<<<<[->>+>
+>>>>>>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<[->>>
+>>>>>>>>>>>>>>>+>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>[-<
+<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>]<]<<[-]<<<<<<<<<<<<<<<<<<<<
+<[-]>[-]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]>[-<<<<<<<<<<<<<<<<
++>>>>>>>>>>>>>>>>]<<<[-]>[-]>[-]>[-]<<<<[->>>>>>>+>>+<<<<<<<<<]>>>>>>>>>[-<<<<
+<<<<<+>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<
+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>
+>>>>>>>>>>>>>>>>>>>>>>>>]<<[->>+>+<<<]>>>[-<<<+>>>]<-<[-]+>[->+>+<<]>>[-<<+>>]
+<[[-]<<[-]>>]<[-]<<[-]>[->+>>+<<<]>>>[-<<<+>>>]<[-]+<[[-]>[-]<<<<<<<<<<<[->>>>
+>>>>>>>>>+>>>>+<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<+>>>>>>>>
+>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<[-]>>>>[-<<+<[>-]>
+[>]<[-<<[-]+>>>>[-]<<<+>]<->>>]<<<[-]<[->+>>+<<<]>>>[-<<<+>>>]<[-]+<[[-]>[-]<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>+>>>>>>>>>>>+<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>
+>>>>>>>>>>+>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<
+<<<<<<[->>>>>->>>>>>>>>>+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>>>
+>>>>>>>>>>>]<<]>[[-]<<<<<<<<<<<<<[->>>+>>>>>>>>>>>+<<<<<<<<<<<<<<]>>>>>>>>>>>>
+>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<[->>>>>+>>>>>>>>>>+<<<<<<<<<<
+<<<<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<[->>>>>>>>>>>>>>>>>>>>->>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>]<]<<[-]<<]>[[-]<<<<<<<<<<[->>>+>>>>>>>>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<
+<<<<<<<<+>>>>>>>>>>>]<<<<<<<<<<<<[->>>>>+>>>>>>>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<
+<<<<<<<<<<+>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>+>>>>
+>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<
+<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>]<]<<[-]<<<<<<<<<<<<<<<<<<<[-]>[-]>>>>>>
+>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<<<<[-
+]<[-]<<<<<<->>>>>>>>>>>>>>[-]+<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<
+<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]<[[-]<[-]>]<[[-]<<<<<<<
+<<<<<[-]+>>>>>>>>>>>>]<]<<<<<<<<<[-]>[-]>>>>>>>]<<<<<<<<<<[->>>>>>>>>>+>+<<<<<
+<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<[[-]<<<<<<<<<<<[-]>>>>>>>>>>>]<<<
+<<<<<<<[-]<]>>>>>>>>>>>[-]+<<<<<<<<<<<<[->>>>>>>>>>>>>+>+<<<<<<<<<<<<<<]>>>>>>
+>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<[[-]<[-]>]<[[-]>+++++++++++++++++++++
+++++++++++++++.[-]<]<<<<<<<<<<<<[->>>>>>>>>>>>+>+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-
+<<<<<<<<<<<<<+>>>>>>>>>>>>>]<[[-]>[-]+++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++<<<<<<<<<<<<<[->>>>>>>>>>>>>->>>+<<<<<<<<<<<<<<<<]>>>>>
+>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]<<<[->>>>>>+>+<<<<<<<]>>>>>>>[-
+<<<<<<<+>>>>>>>]<<<<<<[-]>[-]>[-]++++>>>[-<<<<+>->+<[>-]>[>]<[-<[-]++++<[-]<+>
+>>]>>]<<<[-][-]+++++++[->+>>>>+<<<<<]>>>>>[-<<<<<+>>>>>]<<<<<<<[->>>>>>+>+<<<<
+<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>[-<<+<[>-]>
+[>]<[-<<<<<<<<<<<<<<<[-]+>>>>>>>>>>>>>>>>>[-]<<<+>]<->>>]<<<[-]<[-]<<<<<<<<<<<
+<<[->>>>>>>>>>>>>+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>
+>>]<[[-]<<[-]+++++++>>]<<<<<<<<<<<<<[-]>>>>>>>>>>>[->>+>+<<<]>>>[-<<<+>>>]<<<<
+<<<<<<<<<<[-]+>>>>>>>>>>>>>[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<[-]>>>>>>>>>>
+>>>>]<[-]<<<<<<<<<<<<<[->>>>>>>>>>>>>+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<
+<<<<<<<+>>>>>>>>>>>>>>]<[[-]>++++++++++++++++++++++++++++++++.[-]<]<<<<<<<<<<<
+<<[-]>>>>>>>>>>>[->>+>+<<<]>>>[-<<<+>>>]<-<<<<<<<<<<<<<[-]+>>>>>>>>>>>>>[->+>+
+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>]<[-]<<<<<<<<<<<<<[->>>>>>>>>
+>>>>+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<[[-]>++++
+++++++++++++++++++++++++++++++++++++++++++.[-]<]<<<<<<<<<<<<<[-]>>>>>>>>>>>[->
+>+>+<<<]>>>[-<<<+>>>]<--<<<<<<<<<<<<<[-]+>>>>>>>>>>>>>[->+>+<<]>>[-<<+>>]<[[-]
+<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>]<[-]<<<<<<<<<<<<<[->>>>>>>>>>>>>+>+<<<<<<<<<<<
+<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<[[-]>++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++.[-]<]<<<<<<<<<<<<<[-]>>>>>>>>>>>[->>+>+<<
+<]>>>[-<<<+>>>]<---<<<<<<<<<<<<<[-]+>>>>>>>>>>>>>[->+>+<<]>>[-<<+>>]<[[-]<<<<<
+<<<<<<<<<[-]>>>>>>>>>>>>>>]<[-]<<<<<<<<<<<<<[->>>>>>>>>>>>>+>+<<<<<<<<<<<<<<]>
+>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<[[-]>+++++++++++++++++++++++++++
+++++++++++++++++++.[-]<]<<<<<<<<<<<<<[-]>>>>>>>>>>>[->>+>+<<<]>>>[-<<<+>>>]<--
+--<<<<<<<<<<<<<[-]+>>>>>>>>>>>>>[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<[-]>>>>>
+>>>>>>>>>]<[-]<<<<<<<<<<<<<[->>>>>>>>>>>>>+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<
+<<<<<<<<<<<<+>>>>>>>>>>>>>>]<[[-]>++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++.[-]<]<<<<<<<<<<<<<[-]>>>>>>>>>>>[->>+>+<<<]>>>[-<<<+>>>]<---
+--<<<<<<<<<<<<<[-]+>>>>>>>>>>>>>[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<[-]>>>>>
+>>>>>>>>>]<[-]<<<<<<<<<<<<<[->>>>>>>>>>>>>+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<
+<<<<<<<<<<<<+>>>>>>>>>>>>>>]<[[-]>+++++++++++++++++++++++++++++++++++++++++++.
+[-]<]<<<<<<<<<<<<<[-]>>>>>>>>>>>[->>+>+<<<]>>>[-<<<+>>>]<------<<<<<<<<<<<<<[-
+]+>>>>>>>>>>>>>[->+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>]<[-]<<<
+<<<<<<<<<<[->>>>>>>>>>>>>+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>
+>>>>>>>>>>]<[[-]>++++++++++++++++++++++++++++++++++++++++++.[-]<]<<<<<<<<<<<<<
+[-]>>>>>>>>>>>[->>+>+<<<]>>>[-<<<+>>>]<-------<<<<<<<<<<<<<[-]+>>>>>>>>>>>>>[-
+>+>+<<]>>[-<<+>>]<[[-]<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>]<[-]<<<<<<<<<<<<<[->>>>>
+>>>>>>>>+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<[[-]>
++++++++++++++++++++++++++++++++++++++.[-]<]<<<<<<<<<<<<<[-]>>>>>>>>>>[-]>[-]>[
+-]<<<]<<<<[-]>[-]+>[-]>[-]<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<
+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>
+>>>>>>>]<<<<<<[->>>>+>>+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]<<[->>+>+<<<]>>>[-<<<+>>>
+]<-<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<<[-]>[->+>>+<<<]>>>[-<<<+>>>]<[-
+]+<[[-]>[-]<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<[->>>>>>>>>>>+>+<<<<<<<<<<<<]>>>>>>>>>>>
+>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<<<<<[-]>>>>[-<<+<[>-]>[>]<[-<<[-]+>>>>[-]<<<+>]<
+->>>]<<<[-]<[->+>>+<<<]>>>[-<<<+>>>]<[-]+<[[-]>[-]<<<<<<<<<<[->>+>>>>>>>>>+<<<
+<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<<<<<<<<<<[->>+>>>>>>>>+<<<<<<<<
+<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>
+>>>>>->>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<
+<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<<]>[[-]<<<<<<<<<<<<<<<<<<<<<<<<
+<<[->>>>>>>>>>>>>>>>>>+>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>
+>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<
+<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>+>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>
+>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<
+<<<<<<<<<[->>->>>>>>>>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<]<<[-]<<]
+>[[-]<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>+>>>>>>+<<<<<<<<<<<<<<<<<<<<<<
+<<]>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>
+]<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>+>>>>>+<<<<<<<<<<<<<<<<<<<<<<<]>>>
+>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<[
+->>+>>>>>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<]<<[-]<<<<[-]<<<<<<<<<<<<<<<<<[-]>
+[-]>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>]>[-<<<<<<<<<<<<<<<
+<<<+>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<-]>>>>>>>>>>>>>++++++++++.[-]<<<<[-]>[-]++>
+[-]>[-]<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<
+<<]>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>
+]<<<<<<[->>>>+>>+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]<<[->>+>+<<<]>>>[-<<<+>>>]<-<[-]
++>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<<[-]>[->+>>+<<<]>>>[-<<<+>>>]<[-]+<[[-]
+>[-]<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<[->>>>>>>>>>>+>+<<<<<<<<<<<<]>>>>>>
+>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<<<<<[-]>>>>[-<<+<[>-]>[>]<[-<<[-]+>>>>[-]<<
+<+>]<->>>]<<<[-]<[->+>>+<<<]>>>[-<<<+>>>]<[-]+<[[-]>[-]<<<<<<<<<<[->>+>>>>>>>>
+>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<<<<<<<<<<[->>+>>>>>>>>+<<<
+<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>
+>>>>>>>>>>>>>>->>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<]>[[-]<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>+>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>+>>>>>>>>
++<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<[->>->>>>>>>>+<<<<<<<<<<]>>>
+>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<]<<[-]<<]>[[-]<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>
+>>>>>>>>>>>>>>>+>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-
+<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<<<<<<<<<
+<[->>>>>>>>>>>>>>>>>>>>+>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>
+>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>]<<<<<<<[->>+>>>>>+<<<
+<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<]<<[-]<<<<[-]<<<<<<<<<<<<<<<<<<<[-]>[-]>>>>>>>>
+>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>]>[-<<<<<<<<<<<<<<<<<<<<
++>>>>>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<-]
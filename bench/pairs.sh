@@ -0,0 +1,85 @@
+#!/bin/sh
+# Counts which interpreter instructions run back to back, for picking superinstructions.
+#
+#   bench/pairs.sh [program.b...] > bench/pairs.txt
+#
+# Builds brainfuck-interp with INTERP_PAIRS=1 in a scratch copy of the tree, and runs
+# every program (bench/*.b by default) at each of OPTS, -O1 and -O2 by default. A pair is
+# two instructions next to each other in the program that run one after the other. Each
+# program's pairs are counted as a share of all the pairs it ran, and the table has the
+# average share over the programs at each optlevel, so one long-running program doesn't
+# drown out the rest. It is sorted by the average of those.
+#
+# The programs get the same input as in bench/run.sh.
+
+OPTS=${OPTS:-"1 2"}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+if [ $# -eq 0 ]; then
+    set -- "$ROOT"/bench/*.b
+fi
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT INT TERM
+
+cp "$ROOT"/*.c "$ROOT"/*.h "$ROOT"/Makefile "$TMP/"
+make -s -C "$TMP" INTERP_PAIRS=1 brainfuck-interp || exit 1
+
+text() {
+    awk -v n="$1" 'BEGIN { for (i = 0; i < n; i++) printf "The Quick Brown Fox Jumps Over The Lazy Dog, %d times! {zany} [@`]\n", i }'
+}
+text 15000 > "$TMP/echo.in"
+text 1000 > "$TMP/rot13.in"
+
+: > "$TMP/pairs"
+for prog in "$@"; do
+    name=$(basename "$prog" .b)
+    if [ -f "${prog%.b}.in" ]; then
+        input="${prog%.b}.in"
+    elif [ -f "$TMP/$name.in" ]; then
+        input="$TMP/$name.in"
+    else
+        input=/dev/null
+    fi
+    for o in $OPTS; do
+        "$TMP/brainfuck-interp" -O"$o" "$prog" < "$input" 2>&1 > /dev/null |
+            awk -v run="$o:$name" '$1 == "pair" { print run, $2, $3, $4 }' >> "$TMP/pairs"
+    done
+done
+
+echo "# Instruction pairs in the interpreter, from bench/pairs.sh over:"
+echo "#   $(for prog in "$@"; do basename "$prog" .b; done | tr '\n' ' ' | sed 's/ $//')"
+echo "#"
+printf '%-13s %-12s' '#first' second
+for o in $OPTS; do
+    printf ' %8s' "-O$o"
+done
+echo
+awk -v opts="$OPTS" '{
+        # Each run is optlevel:program. The _w forms have the same name, so add them up first.
+        count[$1 " " $2 " " $3] += $4
+        total[$1] += $4
+    }
+    END {
+        nopts = split(opts, opt, " ")
+        for (run in total) {
+            split(run, r, ":")
+            programs[r[1]]++
+        }
+        for (k in count) {
+            split(k, f, " ")
+            split(f[1], r, ":")
+            pair = f[2] " " f[3]
+            share[pair, r[1]] += count[k] / total[f[1]] / programs[r[1]]
+            pairs[pair] = 1
+        }
+        for (pair in pairs) {
+            split(pair, f, " ")
+            line = sprintf("%-13s %-12s", f[1], f[2])
+            sum = 0
+            for (i = 1; i <= nopts; i++) {
+                line = line sprintf(" %7.2f%%", 100 * share[pair, opt[i]])
+                sum += share[pair, opt[i]]
+            }
+            printf "%.6f %s\n", sum / nopts, line
+        }
+    }' "$TMP/pairs" | sort -k1,1gr -k2,3 | cut -d' ' -f2-
@@ -0,0 +1,18 @@
+ROT13 of its input until EOF which reads as 255
+Divides each character by 32 to find the letters
+
+,+[-[->>>>>>>>+>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]<<<<<<<<[-]>[-]>>>[-
+]++++++++++++++++++++++++++++++++>>>[-<<<<<<+>>>->+<[>-]>[>]<[-<[-]+++++++++++
++++++++++++++++++++++<<<[-]<+>>>>>]>>]<<<[-]<<<<[->>>>+>+<<<<<]>>>>>[-<<<<<+>>
+>>>]<--<<[-]+>>[->+>+<<]>>[-<<+>>]<[[-]<<<[-]>>>]<[-]<<<<[->>>>+>+<<<<<]>>>>>[
+-<<<<<+>>>>>]<---<[-]+>[->+>+<<]>>[-<<+>>]<[[-]<<[-]>>]<[-]<[->+>+<<]>>[-<<+>>
+]<[[-]<<[-]+>>]<[-]<[->>+>+<<<]>>>[-<<<+>>>]<[[-]<<<[->>>>+>+<<<<<]>>>>>[-<<<<
+<+>>>>>]<[[-]>[-]++++++++++++++<<<<<[->>>>>>+>>>>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<
+<<<<<+>>>>>>>>>>]<<<<<[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<<<<<<<<[-]>>>>>>>[-<<
++<[>-]>[>]<[-<<<<<[-]+>>>>>>>[-]<<<+>]<->>>]<<<[-]<[-]<<<[->>>+>>+<<<<<]>>>>>[
+-<<<<<+>>>>>]<[-]+<[[-]>[-]<<<<<<<<+++++++++++++>>>>>>>]>[[-]>[-]+++++++++++++
+++++++++++++++<<<<<<<[->>>>>>>>+>>>>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>
+>>>>>>>>>>>]<<<<<[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<<<<<<<<<<[-]>>>>>>>>>[-<<+
+<[>-]>[>]<[-<<<<<<<[-]+>>>>>>>>>[-]<<<+>]<->>>]<<<[-]<[-]<<<<<[->>>>>+>+<<<<<<
+]>>>>>>[-<<<<<<+>>>>>>]<[[-]<<<<<<<<<------------->>>>>>>>>]<]<<<<[-]>>]<]<<[-
+]<<[-]>[-]<<.[-],+]
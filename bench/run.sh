@@ -0,0 +1,143 @@
+#!/bin/sh
+# Times the programs in bench/ on every backend and optlevel.
+#
+#   bench/run.sh [program.b...]        (or make bench)
+#
+# Each program runs RUNS times on brainfuck-jit, brainfuck-interp and bf2c, at -O0, -O1
+# and -O2, and the table has the median and standard deviation of the wall clock time
+# in milliseconds. compile is the median time it takes to get something runnable:
+# brainfuck-jit -c and brainfuck-interp -c parse and compile without running, and for
+# bf2c it is bf2c plus $CC -O2. size is the machine code the JIT generated (from its
+# perf map) or the text size of the bf2c executable. Every output is checked against
+# the first one, so a backend that gets it wrong shows up as BAD.
+#
+# program.in is the input of program.b if there is one. echo and rot13 read generated
+# text instead, and everything else reads /dev/null.
+#
+# Set BACKENDS, OPTS and RUNS to pick the backends, optlevels and number of runs, and
+# CC for the C compiler bf2c output is built with.
+
+BACKENDS=${BACKENDS:-"jit interp bf2c"}
+OPTS=${OPTS:-"0 1 2"}
+RUNS=${RUNS:-5}
+CC=${CC:-cc}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+if [ $# -eq 0 ]; then
+    set -- "$ROOT"/bench/*.b
+fi
+
+make -s -C "$ROOT" brainfuck-jit brainfuck-interp bf2c || exit 1
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT INT TERM
+
+# The same text every time: 1 MB for echo, 64 KB for rot13.
+text() {
+    awk -v n="$1" 'BEGIN { for (i = 0; i < n; i++) printf "The Quick Brown Fox Jumps Over The Lazy Dog, %d times! {zany} [@`]\n", i }'
+}
+text 15000 > "$TMP/echo.in"
+text 1000 > "$TMP/rot13.in"
+
+input_for() {
+    name=$(basename "$1" .b)
+    if [ -f "${1%.b}.in" ]; then
+        echo "${1%.b}.in"
+    elif [ -f "$TMP/$name.in" ]; then
+        echo "$TMP/$name.in"
+    else
+        echo /dev/null
+    fi
+}
+
+now_ms() {
+    echo $(($(date +%s%N) / 1000000))
+}
+
+# Prints the median and standard deviation of the numbers on stdin.
+stats() {
+    sort -n | awk '{ t[NR] = $1; sum += $1; sq += $1 * $1 }
+        END { m = sum / NR; v = sq / NR - m * m; printf "%8d %8.1f", t[int((NR + 1) / 2)], sqrt(v > 0 ? v : 0) }'
+}
+
+median() {
+    sort -n | awk '{ t[NR] = $1 } END { printf "%d", t[int((NR + 1) / 2)] }'
+}
+
+# Makes $TMP/run run the program with backend $1 at optlevel $2, and prints how long
+# that took in milliseconds.
+build() {
+    start=$(now_ms)
+    case $1 in
+    jit)
+        "$ROOT/brainfuck-jit" -c -O"$2" "$3" > /dev/null || return 1
+        printf '#!/bin/sh\nexec "%s" -O%s "%s"\n' "$ROOT/brainfuck-jit" "$2" "$3" > "$TMP/run"
+        ;;
+    interp)
+        "$ROOT/brainfuck-interp" -c -O"$2" "$3" > /dev/null || return 1
+        printf '#!/bin/sh\nexec "%s" -O%s "%s"\n' "$ROOT/brainfuck-interp" "$2" "$3" > "$TMP/run"
+        ;;
+    bf2c)
+        "$ROOT/bf2c" -O"$2" "$3" > "$TMP/prog.c" && $CC -O2 -w "$TMP/prog.c" -o "$TMP/prog" || return 1
+        printf '#!/bin/sh\nexec "%s"\n' "$TMP/prog" > "$TMP/run"
+        ;;
+    esac
+    chmod +x "$TMP/run"
+    echo $(($(now_ms) - start))
+}
+
+# Prints how many bytes of code backend $1 made at optlevel $2, or - if we can't tell.
+code_size() {
+    case $1 in
+    jit)
+        BRAINFUCK_PERF=map "$ROOT/brainfuck-jit" -c -O"$2" "$3" > /dev/null &
+        pid=$!
+        wait $pid
+        if [ -f "/tmp/perf-$pid.map" ]; then
+            awk '{ n = 0; for (i = 1; i <= length($2); i++) n = n * 16 + index("0123456789abcdef", substr($2, i, 1)) - 1; size += n }
+                END { print size + 0 }' "/tmp/perf-$pid.map"
+            rm -f "/tmp/perf-$pid.map"
+        else
+            echo -
+        fi
+        ;;
+    bf2c)
+        size "$TMP/prog" 2> /dev/null | awk 'NR == 2 { print $1 }' | grep . || echo -
+        ;;
+    *)
+        echo -
+        ;;
+    esac
+}
+
+printf '%-16s %-7s %3s %8s %8s %8s %8s  %s\n' program backend opt median stdev compile size output
+for prog in "$@"; do
+    name=$(basename "$prog" .b)
+    input=$(input_for "$prog")
+    rm -f "$TMP/expected"
+    for b in $BACKENDS; do
+        for o in $OPTS; do
+            : > "$TMP/compile"
+            for i in $(seq "$RUNS"); do
+                build "$b" "$o" "$prog" >> "$TMP/compile" || break
+            done
+            if [ "$(wc -l < "$TMP/compile")" -ne "$RUNS" ]; then
+                printf '%-16s %-7s %3s %s\n' "$name" "$b" "$o" "failed to compile"
+                continue
+            fi
+            : > "$TMP/times"
+            check=ok
+            for i in $(seq "$RUNS"); do
+                start=$(now_ms)
+                "$TMP/run" < "$input" > "$TMP/out"
+                echo $(($(now_ms) - start)) >> "$TMP/times"
+                if [ ! -f "$TMP/expected" ]; then
+                    mv "$TMP/out" "$TMP/expected"
+                elif ! cmp -s "$TMP/out" "$TMP/expected"; then
+                    check=BAD
+                fi
+            done
+            printf '%-16s %-7s %3s %s %8s %8s  %s\n' "$name" "$b" "$o" "$(stats < "$TMP/times")" \
+                "$(median < "$TMP/compile")" "$(code_size "$b" "$o" "$prog")" "$check"
+        done
+    done
+done
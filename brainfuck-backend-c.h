@@ -19,43 +19,97 @@ static const char init[] =
 "#include <stdio.h>\n"
 "#include <stdlib.h>\n"
 "#include <stdint.h>\n"
+"#include <string.h>\n"
 "\n"
 "int main(void)\n"
-"{\n"
-"    uint8_t *cells = (uint8_t *)calloc(1, 65536);\n"
-"    if (cells == NULL) {\n"
-"        puts(\"Out of memory\");\n"
-"        return 1;\n"
-"    }\n"
-"    uint8_t *cell = cells;\n";
+"{\n";
 
 static const char cleanup[] =
-"    free(cells);\n"
+"    free(tape);\n"
 "    return 0;\n"
 "}\n";
-static int indent = 4;
-#define print(fmt, ...) printf("%*s" fmt, indent, "", ##__VA_ARGS__)
+#include <stdarg.h>
 
-static void run_opcodes(bf_opcode *opcodes, size_t len)
+// Writes a string through putchar_ptr.
+static void emit_raw(int (*putchar_ptr)(int), const char *str, size_t len)
 {
-    fwrite(init, 1, sizeof(init) - 1, stdout);
+    for (size_t i = 0; i < len; i++) {
+        putchar_ptr((unsigned char)str[i]);
+    }
+}
+
+// printf()s an indented line through putchar_ptr.
+static void emit(int (*putchar_ptr)(int), int indent, const char *fmt, ...)
+{
+    char buf[128];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    for (int i = 0; i < indent; i++) {
+        putchar_ptr(' ');
+    }
+    emit_raw(putchar_ptr, buf, (size_t)len < sizeof(buf) ? (size_t)len : sizeof(buf) - 1);
+}
+#define print(fmt, ...) emit(putchar_ptr, indent, fmt, ##__VA_ARGS__)
+
+// Nothing to compile, the IR is converted to C when it is run.
+static bool prepare_opcodes(brainfuck_program *program)
+{
+    (void)program;
+    return true;
+}
+
+static int run_opcodes(brainfuck_program *program, int (*putchar_ptr)(int), int (*getchar_ptr)(void))
+{
+    (void)getchar_ptr;
+    bf_opcode *opcodes = program->opcodes;
+    size_t len = program->opcodes_len;
+    emit_raw(putchar_ptr, init, sizeof(init) - 1);
     int indent = 4;
+    // Same tape as the interpreter: what analyze_tape() found, or 65536 cells, with
+    // zeroed padding on either side.
+    int32_t min = program->tape_bounded ? program->tape_min : 0;
+    int32_t max = program->tape_bounded ? program->tape_max : 65535;
+    size_t pad = 64 + (size_t)program->tape_stride;
+    print("uint%d_t *tape = (uint%d_t *)calloc(%zu, %d);\n", CELL_BITS, CELL_BITS, (size_t)(max - min) + 1 + 2 * pad, CELL_BYTES);
+    print("if (tape == NULL) {\n");
+    print("    puts(\"Out of memory\");\n");
+    print("    return 1;\n");
+    print("}\n");
+    print("uint%d_t *cells = tape + %zu, *cells_end = cells + %d;\n", CELL_BITS, pad, max - min + 1);
+    print("uint%d_t *cell = cells + %d;\n", CELL_BITS, -min);
     for (size_t i = 0; i < len; i++) {
         switch (opcodes[i].op) {
         case bf_opcode_add:
-            print("*cell += %d;\n", opcodes[i].amount);
+            print("cell[%d] += %d;\n", opcodes[i].offset, opcodes[i].amount);
             break;
         case bf_opcode_move:
             print("cell += %d;\n", opcodes[i].amount);
             break;
         case bf_opcode_put:
-            print("putchar(*cell);\n");
+            print("putchar(cell[%d]);\n", opcodes[i].offset);
             break;
         case bf_opcode_get:
-            print("*cell = getchar();\n");
+            // EOF is 0xFF no matter how wide the cells are.
+            print("cell[%d] = (uint8_t)getchar();\n", opcodes[i].offset);
             break;
         case bf_opcode_clear:
-            print("*cell = 0;\n");
+            print("cell[%d] = 0;\n", opcodes[i].offset);
+            break;
+        case bf_opcode_scan:
+            // libc's memchr is vectorized
+            if (opcodes[i].amount == 1 && CELL_BITS == 8) {
+                print("cell = (uint8_t *)memchr(cell, 0, cells_end - cell);\n");
+            } else {
+                print("while (*cell) cell += %d;\n", opcodes[i].amount);
+            }
+            break;
+        case bf_opcode_check:
+            print("if (cell + %d < cells || cell + %d >= cells_end) {\n", opcodes[i].amount, opcodes[i].offset);
+            print("    fputs(\"Error: the program ran off the tape\\n\", stderr);\n");
+            print("    return 1;\n");
+            print("}\n");
             break;
         case bf_opcode_start:
             print("while (*cell) {\n");
@@ -66,18 +120,23 @@ static void run_opcodes(bf_opcode *opcodes, size_t len)
             print("}\n");
             break;
         case bf_opcode_copy_mul:
-            if ((opcodes[i].amount & 0xFF) == 1) {
-                print("cell[%d] += *cell;\n", opcodes[i].amount >> 8);
+            if (copy_mul_factor(opcodes[i].amount) == 1) {
+                print("cell[%d] += cell[%d];\n", opcodes[i].offset + copy_mul_target(opcodes[i].amount), opcodes[i].offset);
             } else {
-                print("cell[%d] += *cell * %d;\n", opcodes[i].amount >> 8, opcodes[i].amount & 0xFF);
+                print("cell[%d] += cell[%d] * %d;\n", opcodes[i].offset + copy_mul_target(opcodes[i].amount), opcodes[i].offset, copy_mul_factor(opcodes[i].amount));
             }
             break;
         default:
             break;
         }
     }
-    fwrite(cleanup, 1, sizeof(cleanup) - 1, stdout);
+    emit_raw(putchar_ptr, cleanup, sizeof(cleanup) - 1);
+    return 0;
+}
 
+static void release_opcodes(brainfuck_program *program)
+{
+    (void)program;
 }
 
 #endif
@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2019 easyaspi314
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ */
+
+/// Ahead of time backend: "running" a program writes it out as a static, libc-free
+/// x86_64 Linux ELF executable.
+///
+/// The file is laid out like so:
+///
+///     [ELF header][program headers][runtime][pad][fuck]   <- R+X, loaded at ELF_BASE
+///     [io][cells][pad]                               <- RW bss, zeroed by the kernel
+///
+/// The runtime is brainfuck-wrapper.S, hand assembled, and fuck is the JIT output from
+/// write_init_code()/compile_opcode()/write_cleanup_code().
+#ifndef BRAINFUCK_BACKEND_ELF_H
+#define BRAINFUCK_BACKEND_ELF_H
+
+#ifndef BRAINFUCK_JIT_C
+#   error "This file is only to be included from brainfuck-jit.c"
+#endif
+
+#if JIT_MODE != 1 || defined(JIT_I386) || defined(_WIN32)
+#   error "The ELF backend needs the x86_64 System V JIT."
+#endif
+
+#ifdef CHECKED
+#   error "The ELF runtime doesn't set up the tape bounds for checked code."
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tunables, same as brainfuck-wrapper.S. Bounded programs get just the cells they use.
+#define ELF_NUM_CELLS 65536
+// The vectorized scans can read a vector past the end of the tape.
+#define ELF_TAPE_PAD 64
+
+// Where we load the executable.
+#define ELF_BASE 0x400000
+#define ELF_PAGE 0x1000
+
+typedef struct {
+    uint8_t  e_ident[16];
+    uint16_t e_type;
+    uint16_t e_machine;
+    uint32_t e_version;
+    uint64_t e_entry;
+    uint64_t e_phoff;
+    uint64_t e_shoff;
+    uint32_t e_flags;
+    uint16_t e_ehsize;
+    uint16_t e_phentsize;
+    uint16_t e_phnum;
+    uint16_t e_shentsize;
+    uint16_t e_shnum;
+    uint16_t e_shstrndx;
+} elf64_ehdr;
+
+typedef struct {
+    uint32_t p_type;
+    uint32_t p_flags;
+    uint64_t p_offset;
+    uint64_t p_vaddr;
+    uint64_t p_paddr;
+    uint64_t p_filesz;
+    uint64_t p_memsz;
+    uint64_t p_align;
+} elf64_phdr;
+
+// text, bss, and a non-executable stack
+#define ELF_NUM_PHDRS 3
+#define ELF_HEADERS_LEN (sizeof(elf64_ehdr) + ELF_NUM_PHDRS * sizeof(elf64_phdr))
+
+// void _start(void)
+// {
+//     io.out = io.out_buffer;
+//     io.out_end = io.in = io.in_end = io.out_buffer + BUFFER_SIZE; // io.in_buffer
+//     io.flush = &my_flush;
+//     io.refill = &my_refill;
+//     fuck(cells, &io);
+//     exit(0);
+// }
+//
+// void my_flush(bf_io *io)
+// {
+//     const uint8_t *p = io->out_buffer;
+//     size_t len = io->out - io->out_buffer;
+//     io->out = io->out_buffer;
+//     // Short writes to ttys, pipes and sockets are normal. Give up on any other error.
+//     while (len != 0) {
+//         ssize_t written = write(STDOUT_FILENO, p, len);
+//         if (written == -EINTR) {
+//             continue;
+//         }
+//         if (written <= 0) {
+//             break;
+//         }
+//         p += written;
+//         len -= written;
+//     }
+// }
+//
+// void my_refill(bf_io *io)
+// {
+//     my_flush(io);
+//     ssize_t len;
+//     do {
+//         len = read(STDIN_FILENO, io->in_buffer, IN_BUFFER_SIZE);
+//     } while (len == -EINTR);
+//     if (len <= 0) {
+//         io->in_buffer[0] = EOF;
+//         len = 1;
+//     }
+//     io->in = io->in_buffer;
+//     io->in_end = io->in_buffer + len;
+// }
+//
+// The generated code flushes before it returns.
+static const uint8_t elf_runtime[] = {
+    // _start:
+    // lea     rdi, [rip + cells]
+    0x48, 0x8d, 0x3d, 0x00, 0x00, 0x00, 0x00,
+    // lea     rsi, [rip + io]
+    0x48, 0x8d, 0x35, 0x00, 0x00, 0x00, 0x00,
+    // lea     rax, [rsi + 88] // io->out_buffer
+    0x48, 0x8d, 0x46, 0x58,
+    // mov     qword ptr[rsi], rax // io->out
+    0x48, 0x89, 0x06,
+    // add     rax, BUFFER_SIZE
+    0x48, 0x05, 0x00, 0x10, 0x00, 0x00,
+    // mov     qword ptr[rsi + 8], rax // io->out_end
+    0x48, 0x89, 0x46, 0x08,
+    // mov     qword ptr[rsi + 16], rax // io->in
+    0x48, 0x89, 0x46, 0x10,
+    // mov     qword ptr[rsi + 24], rax // io->in_end
+    0x48, 0x89, 0x46, 0x18,
+    // lea     rax, [rip + my_flush]
+    0x48, 0x8d, 0x05, 0x1d, 0x00, 0x00, 0x00,
+    // mov     qword ptr[rsi + 32], rax // io->flush
+    0x48, 0x89, 0x46, 0x20,
+    // lea     rax, [rip + my_refill]
+    0x48, 0x8d, 0x05, 0x44, 0x00, 0x00, 0x00,
+    // mov     qword ptr[rsi + 40], rax // io->refill
+    0x48, 0x89, 0x46, 0x28,
+    // call    fuck
+    0xe8, 0x76, 0x00, 0x00, 0x00,
+    // mov     eax, 60 // SYS_exit
+    0xb8, 0x3c, 0x00, 0x00, 0x00,
+    // xor     edi, edi
+    0x31, 0xff,
+    // syscall
+    0x0f, 0x05,
+
+    // my_flush:
+    // lea     rsi, [rdi + 88] // io->out_buffer
+    0x48, 0x8d, 0x77, 0x58,
+    // mov     rdx, qword ptr[rdi]
+    0x48, 0x8b, 0x17,
+    // sub     rdx, rsi
+    0x48, 0x29, 0xf2,
+    // mov     qword ptr[rdi], rsi
+    0x48, 0x89, 0x37,
+    // .Lwrite:
+    // test    rdx, rdx
+    0x48, 0x85, 0xd2,
+    // jz      .Ldone
+    0x74, 0x1f,
+    // mov     eax, 1 // SYS_write
+    0xb8, 0x01, 0x00, 0x00, 0x00,
+    // mov     edi, 1 // STDOUT_FILENO
+    0xbf, 0x01, 0x00, 0x00, 0x00,
+    // syscall
+    0x0f, 0x05,
+    // cmp     rax, -4 // -EINTR
+    0x48, 0x83, 0xf8, 0xfc,
+    // je      .Lwrite
+    0x74, 0xe9,
+    // test    rax, rax
+    0x48, 0x85, 0xc0,
+    // jle     .Ldone
+    0x7e, 0x08,
+    // add     rsi, rax
+    0x48, 0x01, 0xc6,
+    // sub     rdx, rax
+    0x48, 0x29, 0xc2,
+    // jmp     .Lwrite
+    0xeb, 0xdc,
+    // .Ldone:
+    // ret
+    0xc3,
+
+    // my_refill:
+    // push    rdi
+    0x57,
+    // call    my_flush
+    0xe8, 0xc8, 0xff, 0xff, 0xff,
+    // pop     rdi
+    0x5f,
+    // lea     rsi, [rdi + 88 + BUFFER_SIZE] // io->in_buffer
+    0x48, 0x8d, 0xb7, 0x58, 0x10, 0x00, 0x00,
+    // mov     qword ptr[rdi + 16], rsi // io->in
+    0x48, 0x89, 0x77, 0x10,
+    // mov     r8, rdi
+    0x49, 0x89, 0xf8,
+    // .Lread:
+    // xor     eax, eax // SYS_read
+    0x31, 0xc0,
+    // xor     edi, edi // STDIN_FILENO
+    0x31, 0xff,
+    // mov     edx, IN_BUFFER_SIZE
+    0xba, 0x00, 0x00, 0x01, 0x00,
+    // syscall
+    0x0f, 0x05,
+    // cmp     rax, -4 // -EINTR
+    0x48, 0x83, 0xf8, 0xfc,
+    // je      .Lread
+    0x74, 0xef,
+    // test    rax, rax
+    0x48, 0x85, 0xc0,
+    // jg      .Lgot_input
+    0x7f, 0x08,
+    // mov     byte ptr[rsi], EOF
+    0xc6, 0x06, 0xff,
+    // mov     eax, 1
+    0xb8, 0x01, 0x00, 0x00, 0x00,
+    // .Lgot_input:
+    // add     rsi, rax
+    0x48, 0x01, 0xc6,
+    // mov     qword ptr[r8 + 24], rsi // io->in_end
+    0x49, 0x89, 0x70, 0x18,
+    // ret
+    0xc3,
+    // fuck: follows after the padding
+};
+
+// Offsets of the rip relative displacements we fill in, and where rip is at that point.
+#define ELF_RT_CELLS_DISP 3
+#define ELF_RT_CELLS_RIP 7
+#define ELF_RT_IO_DISP 10
+#define ELF_RT_IO_RIP 14
+// The call to fuck, which is right after the runtime without padding.
+#define ELF_RT_FUCK_DISP 62
+
+// fuck starts on a LOOP_ALIGN boundary, so the loops inside it are aligned too.
+#if LOOP_ALIGN > 1
+#   define ELF_CODE_PAD ((LOOP_ALIGN - (ELF_HEADERS_LEN + sizeof(elf_runtime)) % LOOP_ALIGN) % LOOP_ALIGN)
+#else
+#   define ELF_CODE_PAD 0
+#endif
+
+// Compiles the program into a plain heap buffer.
+static bool prepare_opcodes(brainfuck_program *restrict program)
+{
+    bf_opcode *ir = program->opcodes;
+    size_t len = program->opcodes_len;
+    size_t pos = 0;
+    size_t memlen = max_code_len(ir, len);
+    raw_opcode *opcodes = (raw_opcode *)malloc(memlen);
+    if (opcodes == NULL) {
+        return false;
+    }
+
+    write_init_code(opcodes, &pos);
+    for (size_t i = 0; i < len; i++) {
+        compile_opcode(&ir[i], opcodes, &pos);
+    }
+    write_cleanup_code(opcodes, &pos);
+
+    program->code = opcodes;
+    program->code_len = memlen;
+    program->code_size = pos;
+
+    free(program->opcodes);
+    program->opcodes = NULL;
+    return true;
+}
+
+// Writes data through putchar_ptr.
+static void elf_write(int (*putchar_ptr)(int), const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++) {
+        putchar_ptr(p[i]);
+    }
+}
+
+// Writes the executable through putchar_ptr.
+static int run_opcodes(brainfuck_program *restrict program, int (*putchar_ptr)(int), int (*getchar_ptr)(void))
+{
+    (void)getchar_ptr;
+    size_t code_pad = ELF_CODE_PAD;
+    uint64_t text_len = ELF_HEADERS_LEN + sizeof(elf_runtime) + code_pad + program->code_size;
+    // Leave an unmapped page between the text and the bss.
+    uint64_t bss_addr = ELF_BASE + ((text_len + ELF_PAGE - 1) & ~(uint64_t)(ELF_PAGE - 1)) + ELF_PAGE;
+    uint64_t runtime_addr = ELF_BASE + ELF_HEADERS_LEN;
+    int32_t min = program->tape_bounded ? program->tape_min : 0;
+    uint64_t num_cells = program->tape_bounded ? (uint64_t)(program->tape_max - min) + 1 : ELF_NUM_CELLS;
+
+    elf64_ehdr ehdr;
+    memset(&ehdr, 0, sizeof(ehdr));
+    memcpy(ehdr.e_ident, "\x7f" "ELF", 4);
+    ehdr.e_ident[4] = 2; // ELFCLASS64
+    ehdr.e_ident[5] = 1; // ELFDATA2LSB
+    ehdr.e_ident[6] = 1; // EV_CURRENT
+    ehdr.e_type = 2; // ET_EXEC
+    ehdr.e_machine = 62; // EM_X86_64
+    ehdr.e_version = 1;
+    ehdr.e_entry = runtime_addr;
+    ehdr.e_phoff = sizeof(elf64_ehdr);
+    ehdr.e_ehsize = sizeof(elf64_ehdr);
+    ehdr.e_phentsize = sizeof(elf64_phdr);
+    ehdr.e_phnum = ELF_NUM_PHDRS;
+
+    elf64_phdr phdrs[ELF_NUM_PHDRS];
+    memset(phdrs, 0, sizeof(phdrs));
+    // text: headers, runtime and code, R+X
+    phdrs[0].p_type = 1; // PT_LOAD
+    phdrs[0].p_flags = 4 | 1; // PF_R | PF_X
+    phdrs[0].p_offset = 0;
+    phdrs[0].p_vaddr = phdrs[0].p_paddr = ELF_BASE;
+    phdrs[0].p_filesz = phdrs[0].p_memsz = text_len;
+    phdrs[0].p_align = ELF_PAGE;
+    // bss: io and cells, RW
+    phdrs[1].p_type = 1; // PT_LOAD
+    phdrs[1].p_flags = 4 | 2; // PF_R | PF_W
+    phdrs[1].p_offset = 0;
+    phdrs[1].p_vaddr = phdrs[1].p_paddr = bss_addr;
+    phdrs[1].p_filesz = 0;
+    phdrs[1].p_memsz = sizeof(bf_io) + num_cells * sizeof(bf_cell) + ELF_TAPE_PAD;
+    phdrs[1].p_align = ELF_PAGE;
+    // stack, RW
+    phdrs[2].p_type = 0x6474e551; // PT_GNU_STACK
+    phdrs[2].p_flags = 4 | 2; // PF_R | PF_W
+    phdrs[2].p_align = 16;
+
+    uint8_t runtime[sizeof(elf_runtime)];
+    memcpy(runtime, elf_runtime, sizeof(elf_runtime));
+    // Cell 0 goes after the cells left of it.
+    int32_t disp = (int32_t)(bss_addr + sizeof(bf_io) - (int64_t)min * (int64_t)sizeof(bf_cell) - (runtime_addr + ELF_RT_CELLS_RIP));
+    memcpy(runtime + ELF_RT_CELLS_DISP, &disp, sizeof(int32_t));
+    disp = (int32_t)(bss_addr - (runtime_addr + ELF_RT_IO_RIP));
+    memcpy(runtime + ELF_RT_IO_DISP, &disp, sizeof(int32_t));
+    memcpy(&disp, runtime + ELF_RT_FUCK_DISP, sizeof(int32_t));
+    disp += (int32_t)code_pad;
+    memcpy(runtime + ELF_RT_FUCK_DISP, &disp, sizeof(int32_t));
+
+    elf_write(putchar_ptr, &ehdr, sizeof(ehdr));
+    elf_write(putchar_ptr, phdrs, sizeof(phdrs));
+    elf_write(putchar_ptr, runtime, sizeof(runtime));
+    for (size_t i = 0; i < code_pad; i++) {
+        // int3
+        putchar_ptr(0xcc);
+    }
+    elf_write(putchar_ptr, program->code, program->code_size);
+    return 0;
+}
+
+static void release_opcodes(brainfuck_program *restrict program)
+{
+    free(program->code);
+    program->code = NULL;
+}
+
+#endif // BRAINFUCK_BACKEND_ELF_H
@@ -22,22 +22,88 @@
 #endif
 #include <string.h>
 
-// All instructions are 8 bytes. This is wasteful, but fast to parse and calculate.
+// There is no machine code, these only size the code buffer of the JIT backends.
 #define MAX_INSN_LEN sizeof(int) * 2
 // size of init[] - no op
 #define INIT_LEN 0
 // size of cleanup[]
 #define CLEANUP_LEN sizeof(int) * 2
-#define bf_opcode_ext_shl_add '{'
-#define bf_opcode_ext_shl_sub '}'
-#define bf_opcode_ext_copy '"'
-#define bf_opcode_ext_mul 'x'
-#define bf_opcode_ext_inc 'i'
-#define bf_opcode_ext_dec 'd'
-#define bf_opcode_ext_add 'A'
-#define bf_opcode_ext_inc_move 'I'
-#define bf_opcode_ext_dec_move 'D'
-#define bf_opcode_ext_move 'M'
+
+// Dispatch: GCC and Clang jump straight from the end of one handler to the next through
+// a table of label addresses (computed goto), so each handler gets its own indirect
+// branch and its own history in the branch predictor. Other compilers, and
+// -DINTERP_SWITCH, go through a switch.
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(INTERP_SWITCH)
+#   define INTERP_THREADED 1
+#else
+#   define INTERP_THREADED 0
+#endif
+
+// What run_opcodes() runs. prepare_opcodes() decodes each op of the IR into one of these,
+// picking the handler for its amount and unpacking its operands, so the handlers don't
+// look at anything they don't need.
+//
+// The program is a string of bytes: the instruction, then its operands. Operands are
+// signed bytes, and the _w forms have 32-bit operands for the few that don't fit. Jumps
+// are relative to the next instruction.
+typedef enum {
+    bf_insn_move, // cell += a
+    bf_insn_move_w,
+    bf_insn_inc_move, // ++cell
+    bf_insn_dec_move, // --cell
+    bf_insn_add, // cell[a] += b
+    bf_insn_add_w,
+    bf_insn_inc, // ++cell[a]
+    bf_insn_inc_w,
+    bf_insn_dec, // --cell[a]
+    bf_insn_dec_w,
+    bf_insn_clear, // cell[a] = 0
+    bf_insn_clear_w,
+    bf_insn_put, // putchar(cell[a])
+    bf_insn_put_w,
+    bf_insn_get, // cell[a] = getchar()
+    bf_insn_get_w,
+    bf_insn_start, // if (*cell == 0) jump a, past the end
+    bf_insn_start_w,
+    bf_insn_end, // if (*cell != 0) jump a, back to the body
+    bf_insn_end_w,
+    bf_insn_scan, // while (*cell) cell += a
+    bf_insn_scan_w,
+    bf_insn_scan_right, // while (*cell) ++cell, with memchr()
+    bf_insn_check, // cell + a to cell + b must be on the tape, always 32-bit
+    bf_insn_copy, // cell[b] += cell[a]
+    bf_insn_copy_w,
+    bf_insn_mul, // cell[b] += cell[a] * c
+    bf_insn_mul_w,
+    bf_insn_shl_add, // cell[b] += cell[a] << c
+    bf_insn_shl_add_w,
+    bf_insn_shl_sub, // cell[b] -= cell[a] << c
+    bf_insn_shl_sub_w,
+    // Superinstructions, see fuse_insns().
+    bf_insn_add_move, // cell[a] += b; cell += c
+    bf_insn_move_add, // cell += a; cell[b] += c
+    bf_insn_add_add, // cell[a] += b; cell[c] += d
+    bf_insn_add_put, // cell[a] += b; putchar(cell[c])
+    bf_insn_move_start, // cell += a; then a start that jumps b
+    bf_insn_move_end, // cell += a; then an end that jumps b
+    bf_insn_add_end, // cell[a] += b; then an end that jumps c
+    bf_insn_count, // -DPROFILE: ++profile_counts[a], always 32-bit
+    bf_insn_halt,
+    bf_insn_types
+} bf_insn_type;
+
+// One decoded op, before it is encoded.
+typedef struct {
+    int op;
+    int32_t a;
+    int32_t b;
+    int32_t c;
+    int32_t d;
+#ifdef PROFILE
+    // -DPROFILE: Counted every time it runs. Loops count their body instead.
+    uint32_t site;
+#endif
+} bf_insn;
 
 static inline int log_2(int val) {
     switch (val) {
@@ -59,142 +125,698 @@ static inline int log_2(int val) {
     }
 }
 
-// Interprets our pre-parsed format.
-static void run_opcodes(bf_opcode *restrict opcodes, size_t len)
+// Decodes op into insn, in its short form. Returns false if it doesn't do anything.
+// prepare_opcodes() works out the jumps.
+static bool decode_opcode(const bf_opcode *restrict op, bf_insn *restrict insn)
 {
-    uint8_t *cells = (uint8_t *)calloc(1, 65536);
-    if (!cells) {
-        printf("Out of memory\n");
-        exit(1);
+    int32_t amount = 0, target = 0, temp = 0;
+    memset(insn, 0, sizeof(*insn));
+    insn->a = op->offset;
+#ifdef PROFILE
+    insn->site = op->site;
+#endif
+    switch (op->op) {
+    case bf_opcode_move:
+        insn->a = op->amount;
+        if (op->amount == 1) {
+            insn->op = bf_insn_inc_move;
+        } else if (op->amount == -1) {
+            insn->op = bf_insn_dec_move;
+        } else {
+            insn->op = bf_insn_move;
+        }
+        return true;
+    case bf_opcode_add:
+        insn->b = op->amount;
+        if (op->amount == 1) {
+            insn->op = bf_insn_inc;
+        } else if (op->amount == -1) {
+            insn->op = bf_insn_dec;
+        } else {
+            insn->op = bf_insn_add;
+        }
+        return true;
+    case bf_opcode_clear:
+        insn->op = bf_insn_clear;
+        return true;
+    case bf_opcode_put:
+        insn->op = bf_insn_put;
+        return true;
+    case bf_opcode_get:
+        insn->op = bf_insn_get;
+        return true;
+    case bf_opcode_start:
+        insn->op = bf_insn_start;
+        return true;
+    case bf_opcode_end:
+        insn->op = bf_insn_end;
+        return true;
+    case bf_opcode_scan:
+        insn->a = op->amount;
+        // libc's memchr is vectorized
+        insn->op = op->amount == 1 && CELL_BITS == 8 ? bf_insn_scan_right : bf_insn_scan;
+        return true;
+    case bf_opcode_check:
+        insn->op = bf_insn_check;
+        insn->a = op->amount;
+        insn->b = op->offset;
+        return true;
+    // Split up the copy/multiply
+    case bf_opcode_copy_mul:
+        target = copy_mul_target(op->amount);
+        amount = copy_mul_factor(op->amount);
+        insn->b = op->offset + target;
+        if (amount == 0) {
+            return false;
+        } else if (amount == 1) {
+            insn->op = bf_insn_copy;
+        } else if ((temp = log_2(amount))) {
+            insn->op = amount < 0 ? bf_insn_shl_sub : bf_insn_shl_add;
+            insn->c = temp;
+        } else {
+            insn->op = bf_insn_mul;
+            insn->c = amount;
+        }
+        return true;
+    default:
+        return false;
     }
-    uint8_t *cell = cells;
-    int32_t amount = 0, offset = 0, temp = 0;
-    bf_opcode *op = opcodes, *end = opcodes + len;
-    // TODO: update debug logs
-    while (op < end) {
-        switch (op->op) {
-        case bf_opcode_move:
-            if (op->amount == 1) {
-                op->op = bf_opcode_ext_inc_move;
-                ++cell;
-                break;
-            }
-            if (op->amount == -1) {
-                op->op = bf_opcode_ext_dec_move;
-                --cell;
-                break;
-            }
-            op->op = bf_opcode_ext_move;
-            cell += op->amount;
-            break;
-        case bf_opcode_ext_move:
-            bf_log("cell += %d;\n", op->amount);
-            cell += op->amount;
-            break;
-        case bf_opcode_ext_dec_move:
-            --cell;
-            break;
-        case bf_opcode_ext_inc_move:
-            ++cell;
-            break;
-
-        case bf_opcode_add:
-            if (op->amount == 1) {
-                op->op = bf_opcode_ext_inc;
-                ++*cell;
-                break;
-            }
-            if (op->amount == -1) {
-                op->op = bf_opcode_ext_dec;
-                --*cell;
-                break;
-            }
-            op->op = bf_opcode_ext_add;
-            *cell += op->amount;
-            break;
-        case bf_opcode_ext_add:
-            bf_log("*cell += %d;\n", op->amount);
-            *cell += op->amount;
-            break;
-        case bf_opcode_ext_dec:
-            --*cell;
-            break;
-        case bf_opcode_ext_inc:
-            ++*cell;
-            break;
-        case bf_opcode_put:
-            bf_log("putchar(%d /* '%c' */);\n", *cell, *cell);
-            putc(*cell, stdout);
-            break;
-        case bf_opcode_get:
-            *cell = getc(stdin);
-            bf_log("*cell = getchar(); /* %i */;\n", *cell);
-            break;
-        case bf_opcode_clear:
-            bf_log("*cell = 0;\n");
-            *cell = 0;
-            break;
-        case bf_opcode_start:
-            bf_log("if (%i == 0) {\n i += %i;\n}\n", *cell, op->amount);
-            if (*cell == 0) {
-                op += op->amount;
+}
+
+// How many operands each instruction has, and how many bytes it takes with them, in the
+// order of bf_insn_type. Longer than one byte per operand means they are 32-bit.
+static const uint8_t insn_operands[] = {
+    1, 1, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 2, 2, 2, 3, 3, 3, 3, 3, 3,
+    3, 3, 4, 3, 2, 2, 3, 1, 0
+};
+static const uint8_t insn_lengths[] = {
+    2, 5, 1, 1, 3, 9, 2, 5, 2, 5, 2, 5, 2, 5, 2, 5, 2, 5, 2, 5, 2, 5, 1, 9, 3, 9, 4, 13, 4, 13, 4, 13,
+    4, 4, 5, 4, 3, 3, 4, 5, 1
+};
+typedef char insn_operands_check[sizeof(insn_operands) == bf_insn_types ? 1 : -1];
+typedef char insn_lengths_check[sizeof(insn_lengths) == bf_insn_types ? 1 : -1];
+
+static inline bool insn_wide(int op)
+{
+    return insn_lengths[op] != 1 + insn_operands[op];
+}
+
+static inline bool fits_int8(int32_t val)
+{
+    return val >= -128 && val <= 127;
+}
+
+// Picks the _w form of insn if its operands don't fit in a byte. Jumps are done by
+// prepare_opcodes().
+static void widen_insn(bf_insn *insn)
+{
+    if (insn_operands[insn->op] > 0 && !insn_wide(insn->op)
+        && !(fits_int8(insn->a) && fits_int8(insn->b) && fits_int8(insn->c))) {
+        ++insn->op;
+    }
+}
+
+// Writes insn at out, and returns how many bytes it took.
+static size_t encode_insn(uint8_t *restrict out, const bf_insn *restrict insn)
+{
+    int32_t args[4] = { insn->a, insn->b, insn->c, insn->d };
+    int operands = insn_operands[insn->op];
+    out[0] = (uint8_t)insn->op;
+    if (insn_wide(insn->op)) {
+        memcpy(out + 1, args, 4 * (size_t)operands);
+    } else {
+        for (int i = 0; i < operands; i++) {
+            out[1 + i] = (uint8_t)(int8_t)args[i];
+        }
+    }
+    return insn_lengths[insn->op];
+}
+
+static inline bool insn_is_move(int op)
+{
+    return op == bf_insn_move || op == bf_insn_inc_move || op == bf_insn_dec_move;
+}
+
+static inline bool insn_is_add(int op)
+{
+    return op == bf_insn_add || op == bf_insn_inc || op == bf_insn_dec;
+}
+
+// Superinstructions do two instructions for one dispatch. These are the pairs at the top
+// of bench/pairs.txt, down to add+put. Moves and adds are taken in any form, but all the
+// operands have to fit in a byte.
+//
+// Sets fused to what does first and then second, and returns false if there is no such
+// thing. Jumps are left to prepare_opcodes().
+static bool fuse_insns(const bf_insn *restrict first, const bf_insn *restrict second, bf_insn *restrict fused)
+{
+#ifdef INTERP_PAIRS
+    // bench/pairs.sh counts the pairs as they were before.
+    (void)first, (void)second, (void)fused;
+    return false;
+#else
+    bool move = insn_is_move(first->op), add = insn_is_add(first->op);
+    memset(fused, 0, sizeof(*fused));
+    fused->a = first->a;
+    fused->b = add ? first->b : 0;
+    if (insn_is_move(second->op) && add) {
+        fused->op = bf_insn_add_move;
+        fused->c = second->a;
+    } else if (insn_is_add(second->op) && move) {
+        fused->op = bf_insn_move_add;
+        fused->b = second->a;
+        fused->c = second->b;
+    } else if (insn_is_add(second->op) && add) {
+        fused->op = bf_insn_add_add;
+        fused->c = second->a;
+        fused->d = second->b;
+    } else if (second->op == bf_insn_put && add) {
+        fused->op = bf_insn_add_put;
+        fused->c = second->a;
+    } else if (second->op == bf_insn_start && move) {
+        fused->op = bf_insn_move_start;
+    } else if (second->op == bf_insn_end && move) {
+        fused->op = bf_insn_move_end;
+    } else if (second->op == bf_insn_end && add) {
+        fused->op = bf_insn_add_end;
+    } else {
+        return false;
+    }
+    return fits_int8(fused->a) && fits_int8(fused->b) && fits_int8(fused->c) && fits_int8(fused->d);
+#endif
+}
+
+// Encodes the whole program up front, with a halt at the end so the interpreter doesn't
+// have to check where it is. The IR is left alone, and the program is read-only, so it
+// can be interpreted on multiple threads.
+//
+// Nops are left out. Each loop's start is written long, and when we get to its end, a
+// body short enough for byte jumps is moved back over the extra bytes. Jumps are
+// relative, so the loops inside it don't care. Pairs of instructions are fused as they
+// are written, as long as the second one isn't where a jump lands. Loops only take in
+// the move before them and the move or add at the end of their body if their jumps are
+// short.
+static bool prepare_opcodes(brainfuck_program *restrict program)
+{
+    const bf_opcode *ops = program->opcodes;
+    size_t len = program->opcodes_len;
+    // The longest an op gets is a _w multiply.
+    size_t max_len = insn_lengths[bf_insn_mul_w];
+#ifdef PROFILE
+    bf_insn count;
+    memset(&count, 0, sizeof(count));
+    count.op = bf_insn_count;
+    max_len += insn_lengths[bf_insn_count];
+#endif
+    uint8_t *code = (uint8_t *)malloc(len * max_len + insn_lengths[bf_insn_halt]);
+    // Where the start of each open loop is.
+    size_t *starts = (size_t *)malloc((len / 2 + 1) * sizeof(size_t));
+    if (code == NULL || starts == NULL) {
+        free(code);
+        free(starts);
+        return false;
+    }
+    size_t pos = 0, depth = 0;
+    bf_insn insn, fused;
+    // The instruction right before pos, if the next one could be fused onto it.
+    bf_insn last;
+    size_t last_pos = 0;
+    bool fusable = false;
+    for (size_t i = 0; i < len; i++) {
+        if (!decode_opcode(&ops[i], &insn)) {
+            continue;
+        }
+        if (insn.op == bf_insn_start) {
+            // A move that could go in is kept in front as a plain move, which tells the end.
+            if (fusable && fuse_insns(&last, &insn, &fused)) {
+                last.op = bf_insn_move;
+                starts[depth++] = last_pos;
+                pos = last_pos + encode_insn(code + last_pos, &last);
+            } else {
+                starts[depth++] = pos;
+                code[pos] = bf_insn_start_w;
             }
-            break;
-        case bf_opcode_end:
-            bf_log("if (%i != 0) {\n    i += %i;\n}\n", *cell, op->amount);
-            if (*cell != 0) {
-                op += op->amount;
+            pos += insn_lengths[bf_insn_start_w];
+            fusable = false;
+#ifdef PROFILE
+            // Counts the body, and the end jumps back to it.
+            if (insn.site != 0) {
+                count.a = (int32_t)insn.site - 1;
+                pos += encode_insn(code + pos, &count);
             }
-            break;
-        // Split up the opcode using some sneaky gotos
-        case bf_opcode_copy_mul:
-            offset = op->amount >> 8;
-            amount = (int8_t)op->amount;
-            if (amount == 0) {
-                op->op = bf_opcode_nop;
-                break;
-            } else if (amount == 1) {
-                op->op = bf_opcode_ext_copy;
-                op->amount >>= 8;
-                cell[offset] += *cell;
-                break;
-            } else if ((temp = log_2(amount))) {
-                op->amount = (offset << 8) | temp;
-                if (amount < 0) {
-                    op->op = bf_opcode_ext_shl_sub;
-                    cell[offset] -= *cell << temp;
+#endif
+        } else if (insn.op == bf_insn_end) {
+            size_t start = starts[--depth];
+            bool head = code[start] == bf_insn_move;
+            size_t body = start + (head ? insn_lengths[bf_insn_move] : 0) + insn_lengths[bf_insn_start_w];
+            // What the end could be with short jumps.
+            bool tail = fusable && fuse_insns(&last, &insn, &fused);
+            size_t end = tail ? last_pos : pos;
+            int end_op = tail ? fused.op : bf_insn_end;
+            size_t body_len = end - body;
+            ptrdiff_t distance;
+            if (body_len + insn_lengths[end_op] <= 127) {
+                int start_op = head ? bf_insn_move_start : bf_insn_start;
+                memmove(code + start + insn_lengths[start_op], code + body, body_len);
+                body = start + insn_lengths[start_op];
+                end = body + body_len;
+                // Both ends jump between the body and past the end.
+                distance = (ptrdiff_t)(end + insn_lengths[end_op]) - (ptrdiff_t)body;
+                if (!tail) {
+                    fused = insn;
+                    fused.a = (int32_t)-distance;
+                } else if (end_op == bf_insn_add_end) {
+                    fused.c = (int32_t)-distance;
                 } else {
-                    op->op = bf_opcode_ext_shl_add;
-                    cell[offset] += *cell << temp;
+                    fused.b = (int32_t)-distance;
                 }
-                break;
+                pos = end + encode_insn(code + end, &fused);
+                insn.op = start_op;
+                insn.a = head ? (int8_t)code[start + 1] : (int32_t)distance;
+                insn.b = (int32_t)distance;
+                encode_insn(code + start, &insn);
             } else {
-                op->op = bf_opcode_ext_mul;
-                cell[offset] += amount * *cell;
-                break;
+                distance = (ptrdiff_t)(pos + insn_lengths[bf_insn_end_w]) - (ptrdiff_t)body;
+                insn.op = bf_insn_end_w;
+                insn.a = (int32_t)-distance;
+                pos += encode_insn(code + pos, &insn);
+                insn.op = bf_insn_start_w;
+                insn.a = (int32_t)distance;
+                encode_insn(code + body - insn_lengths[bf_insn_start_w], &insn);
             }
-            break;
-        case bf_opcode_ext_mul:
-            offset = op->amount >> 8;
-            amount = (int8_t)op->amount;
-            bf_log("cells[%i] += %i * cells[0];\n", offset, amount);
-            cell[offset] += amount * *cell;
-            break;
-        case bf_opcode_ext_copy:
-            cell[op->amount] += *cell;
-            break;
-        case bf_opcode_ext_shl_add:
-            cell[op->amount>>8] += *cell << (op->amount & 0xFF);
-            break;
-        case bf_opcode_ext_shl_sub:
-            cell[op->amount>>8] -= *cell << (op->amount & 0xFF);
-            break;
-        default:
-            break;
-       }
-       ++op;
-   }
-   free(cells);
+            fusable = false;
+        } else {
+#ifdef PROFILE
+            if (insn.site != 0) {
+                count.a = (int32_t)insn.site - 1;
+                pos += encode_insn(code + pos, &count);
+                fusable = false;
+            }
+#endif
+            if (fusable && fuse_insns(&last, &insn, &fused)) {
+                pos = last_pos + encode_insn(code + last_pos, &fused);
+                fusable = false;
+                continue;
+            }
+            widen_insn(&insn);
+            last = insn;
+            last_pos = pos;
+            fusable = insn_is_move(insn.op) || insn_is_add(insn.op);
+            pos += encode_insn(code + pos, &insn);
+        }
+    }
+    free(starts);
+    insn.op = bf_insn_halt;
+    pos += encode_insn(code + pos, &insn);
+    // Give back what we didn't need.
+    uint8_t *shrunk = (uint8_t *)realloc(code, pos);
+    program->code = shrunk ? shrunk : code;
+    program->code_len = program->code_size = pos;
+    return true;
+}
+
+// Operand n of the instruction at ip, short or 32-bit.
+static inline int32_t insn_arg(const uint8_t *ip, int n)
+{
+    return (int8_t)ip[1 + n];
+}
+
+static inline int32_t insn_arg_w(const uint8_t *ip, int n)
+{
+    int32_t val;
+    memcpy(&val, ip + 1 + 4 * n, 4);
+    return val;
+}
+
+#ifdef INTERP_PAIRS
+// -DINTERP_PAIRS: Counts which instruction runs right after which, when the second one
+// is the next one in the program, and prints the counts to stderr after each run. This
+// is what bench/pairs.sh adds up. The forms of a move or an add go by one name, since a
+// superinstruction would take any of them.
+static const char *const insn_names[] = {
+    "move", "move", "move", "move", "add", "add", "add", "add", "add", "add",
+    "clear", "clear", "put", "put", "get", "get", "start", "start", "end", "end",
+    "scan", "scan", "scan_right", "check", "copy", "copy", "mul", "mul", "shl_add",
+    "shl_add", "shl_sub", "shl_sub", "add_move", "move_add", "add_add", "add_put", "move_start",
+    "move_end", "add_end", "count", "halt"
+};
+typedef char insn_names_check[sizeof(insn_names) / sizeof(insn_names[0]) == bf_insn_types ? 1 : -1];
+
+static inline void count_pair(uint64_t *restrict pairs, const uint8_t **restrict last, const uint8_t *ip)
+{
+    if (*last && *last + insn_lengths[**last] == ip) {
+        ++pairs[**last * bf_insn_types + *ip];
+    }
+    *last = ip;
+}
+
+static void print_pairs(const uint64_t *pairs)
+{
+    for (int first = 0; first < bf_insn_types; first++) {
+        for (int second = 0; second < bf_insn_types; second++) {
+            uint64_t count = pairs[first * bf_insn_types + second];
+            if (count != 0) {
+                fprintf(stderr, "pair %s %s %llu\n", insn_names[first], insn_names[second], (unsigned long long)count);
+            }
+        }
+    }
+}
+#   define COUNT_PAIR() count_pair(pairs, &last, ip)
+#else
+#   define COUNT_PAIR() ((void)0)
+#endif
+
+#if INTERP_THREADED
+#   define INSN(name) do_##name
+#   define DISPATCH() do { COUNT_PAIR(); goto *handlers[*ip]; } while (0)
+#else
+#   define INSN(name) case name
+#   define DISPATCH() goto dispatch
+#endif
+// Goes to the next instruction, len bytes on.
+#define NEXT(len) do { ip += (len); DISPATCH(); } while (0)
+// The _w forms load their operands and go to the short form's handler, which then skips
+// the short form's length. This adds the difference.
+#define WIDE(operands) (ip += 3 * (operands))
+
+// Interprets the encoded program.
+static int run_opcodes(brainfuck_program *restrict program, int (*putchar_ptr)(int), int (*getchar_ptr)(void))
+{
+    // Same buffered I/O and tape as the JIT, -O0 flushes every byte.
+    bf_io *io = alloc_io(putchar_ptr, getchar_ptr, program->optlevel < 1);
+    bf_cell *cell = io ? alloc_tape(program, io) : NULL;
+    if (!cell) {
+        free(io);
+        return BF_OUT_OF_MEMORY;
+    }
+#ifdef INTERP_PAIRS
+    uint64_t *pairs = (uint64_t *)calloc(bf_insn_types * bf_insn_types, sizeof(uint64_t));
+    const uint8_t *last = NULL;
+    if (!pairs) {
+        free_tape(program, io);
+        dealloc_io(io);
+        return BF_OUT_OF_MEMORY;
+    }
+#endif
+#ifdef PROFILE
+    if (!start_profile(program, io)) {
+#ifdef INTERP_PAIRS
+        free(pairs);
+#endif
+        free_tape(program, io);
+        dealloc_io(io);
+        return BF_OUT_OF_MEMORY;
+    }
+#endif
+    int status = 0;
+#if INTERP_THREADED
+    // In the order of bf_insn_type.
+    static const void *const handlers[] = {
+        &&do_bf_insn_move, &&do_bf_insn_move_w, &&do_bf_insn_inc_move, &&do_bf_insn_dec_move,
+        &&do_bf_insn_add, &&do_bf_insn_add_w, &&do_bf_insn_inc, &&do_bf_insn_inc_w,
+        &&do_bf_insn_dec, &&do_bf_insn_dec_w, &&do_bf_insn_clear, &&do_bf_insn_clear_w,
+        &&do_bf_insn_put, &&do_bf_insn_put_w, &&do_bf_insn_get, &&do_bf_insn_get_w,
+        &&do_bf_insn_start, &&do_bf_insn_start_w, &&do_bf_insn_end, &&do_bf_insn_end_w,
+        &&do_bf_insn_scan, &&do_bf_insn_scan_w, &&do_bf_insn_scan_right, &&do_bf_insn_check,
+        &&do_bf_insn_copy, &&do_bf_insn_copy_w, &&do_bf_insn_mul, &&do_bf_insn_mul_w,
+        &&do_bf_insn_shl_add, &&do_bf_insn_shl_add_w, &&do_bf_insn_shl_sub, &&do_bf_insn_shl_sub_w,
+        &&do_bf_insn_add_move, &&do_bf_insn_move_add, &&do_bf_insn_add_add, &&do_bf_insn_add_put,
+        &&do_bf_insn_move_start, &&do_bf_insn_move_end, &&do_bf_insn_add_end,
+        &&do_bf_insn_count, &&do_bf_insn_halt,
+    };
+    typedef char handlers_check[sizeof(handlers) / sizeof(handlers[0]) == bf_insn_types ? 1 : -1];
+    (void)sizeof(handlers_check);
+#endif
+    const uint8_t *ip = (const uint8_t *)program->code;
+    int32_t a = 0, b = 0, c = 0;
+#if !INTERP_THREADED
+dispatch:
+    COUNT_PAIR();
+    switch (*ip) {
+#else
+    DISPATCH();
+    {
+#endif
+    INSN(bf_insn_move_w):
+        a = insn_arg_w(ip, 0);
+        WIDE(1);
+        goto move;
+    INSN(bf_insn_move):
+        a = insn_arg(ip, 0);
+    move:
+        bf_log("cell += %d;\n", a);
+        cell += a;
+        NEXT(2);
+    INSN(bf_insn_inc_move):
+        ++cell;
+        NEXT(1);
+    INSN(bf_insn_dec_move):
+        --cell;
+        NEXT(1);
+    INSN(bf_insn_add_w):
+        a = insn_arg_w(ip, 0);
+        b = insn_arg_w(ip, 1);
+        WIDE(2);
+        goto add;
+    INSN(bf_insn_add):
+        a = insn_arg(ip, 0);
+        b = insn_arg(ip, 1);
+    add:
+        bf_log("cell[%d] += %d;\n", a, b);
+        cell[a] += b;
+        NEXT(3);
+    INSN(bf_insn_inc_w):
+        a = insn_arg_w(ip, 0);
+        WIDE(1);
+        goto inc;
+    INSN(bf_insn_inc):
+        a = insn_arg(ip, 0);
+    inc:
+        ++cell[a];
+        NEXT(2);
+    INSN(bf_insn_dec_w):
+        a = insn_arg_w(ip, 0);
+        WIDE(1);
+        goto dec;
+    INSN(bf_insn_dec):
+        a = insn_arg(ip, 0);
+    dec:
+        --cell[a];
+        NEXT(2);
+    INSN(bf_insn_clear_w):
+        a = insn_arg_w(ip, 0);
+        WIDE(1);
+        goto clear;
+    INSN(bf_insn_clear):
+        a = insn_arg(ip, 0);
+    clear:
+        bf_log("cell[%d] = 0;\n", a);
+        cell[a] = 0;
+        NEXT(2);
+    INSN(bf_insn_put_w):
+        a = insn_arg_w(ip, 0);
+        WIDE(1);
+        goto put;
+    INSN(bf_insn_put):
+        a = insn_arg(ip, 0);
+    put:
+        bf_log("putchar(%d /* '%c' */);\n", cell[a], cell[a]);
+        *io->out++ = cell[a];
+        if (io->out == io->out_end) {
+            io->flush(io);
+        }
+        NEXT(2);
+    INSN(bf_insn_get_w):
+        a = insn_arg_w(ip, 0);
+        WIDE(1);
+        goto get;
+    INSN(bf_insn_get):
+        a = insn_arg(ip, 0);
+    get:
+        if (io->in == io->in_end) {
+            io->refill(io);
+        }
+        cell[a] = *io->in++;
+        bf_log("cell[%d] = getchar(); /* %i */;\n", a, cell[a]);
+        NEXT(2);
+    INSN(bf_insn_start_w):
+        a = insn_arg_w(ip, 0);
+        WIDE(1);
+        goto start;
+    INSN(bf_insn_start):
+        a = insn_arg(ip, 0);
+    start:
+        bf_log("if (%i == 0) {\n    i += %i;\n}\n", *cell, a);
+        if (*cell == 0) {
+            ip += a;
+        }
+        NEXT(2);
+    INSN(bf_insn_end_w):
+        a = insn_arg_w(ip, 0);
+        WIDE(1);
+        goto end;
+    INSN(bf_insn_end):
+        a = insn_arg(ip, 0);
+    end:
+        bf_log("if (%i != 0) {\n    i += %i;\n}\n", *cell, a);
+        if (*cell != 0) {
+            ip += a;
+        }
+        NEXT(2);
+    INSN(bf_insn_scan_w):
+        a = insn_arg_w(ip, 0);
+        WIDE(1);
+        goto scan;
+    INSN(bf_insn_scan):
+        a = insn_arg(ip, 0);
+    scan:
+        bf_log("while (*cell) cell += %d;\n", a);
+        while (*cell) {
+            cell += a;
+        }
+        NEXT(2);
+    INSN(bf_insn_scan_right): {
+        bf_log("while (*cell) cell += 1;\n");
+        bf_cell *found = (bf_cell *)memchr(cell, 0, (size_t)(io->tape_end - cell) * CELL_BYTES);
+        cell = found ? found : io->tape_end;
+        NEXT(1);
+    }
+    INSN(bf_insn_check):
+        a = insn_arg_w(ip, 0);
+        b = insn_arg_w(ip, 1);
+        bf_log("check(cell[%d], cell[%d]);\n", a, b);
+        if (cell + a < io->tape_start || cell + b >= io->tape_end) {
+            status = BF_RAN_OFF_TAPE;
+            goto stop;
+        }
+        NEXT(9);
+    INSN(bf_insn_copy_w):
+        a = insn_arg_w(ip, 0);
+        b = insn_arg_w(ip, 1);
+        WIDE(2);
+        goto copy;
+    INSN(bf_insn_copy):
+        a = insn_arg(ip, 0);
+        b = insn_arg(ip, 1);
+    copy:
+        bf_log("cell[%i] += cell[%i];\n", b, a);
+        cell[b] += cell[a];
+        NEXT(3);
+    INSN(bf_insn_mul_w):
+        a = insn_arg_w(ip, 0);
+        b = insn_arg_w(ip, 1);
+        c = insn_arg_w(ip, 2);
+        WIDE(3);
+        goto mul;
+    INSN(bf_insn_mul):
+        a = insn_arg(ip, 0);
+        b = insn_arg(ip, 1);
+        c = insn_arg(ip, 2);
+    mul:
+        bf_log("cell[%i] += %i * cell[%i];\n", b, c, a);
+        cell[b] += c * cell[a];
+        NEXT(4);
+    INSN(bf_insn_shl_add_w):
+        a = insn_arg_w(ip, 0);
+        b = insn_arg_w(ip, 1);
+        c = insn_arg_w(ip, 2);
+        WIDE(3);
+        goto shl_add;
+    INSN(bf_insn_shl_add):
+        a = insn_arg(ip, 0);
+        b = insn_arg(ip, 1);
+        c = insn_arg(ip, 2);
+    shl_add:
+        cell[b] += cell[a] << c;
+        NEXT(4);
+    INSN(bf_insn_shl_sub_w):
+        a = insn_arg_w(ip, 0);
+        b = insn_arg_w(ip, 1);
+        c = insn_arg_w(ip, 2);
+        WIDE(3);
+        goto shl_sub;
+    INSN(bf_insn_shl_sub):
+        a = insn_arg(ip, 0);
+        b = insn_arg(ip, 1);
+        c = insn_arg(ip, 2);
+    shl_sub:
+        cell[b] -= cell[a] << c;
+        NEXT(4);
+    INSN(bf_insn_add_move):
+        bf_log("cell[%d] += %d; cell += %d;\n", insn_arg(ip, 0), insn_arg(ip, 1), insn_arg(ip, 2));
+        cell[insn_arg(ip, 0)] += insn_arg(ip, 1);
+        cell += insn_arg(ip, 2);
+        NEXT(4);
+    INSN(bf_insn_move_add):
+        bf_log("cell += %d; cell[%d] += %d;\n", insn_arg(ip, 0), insn_arg(ip, 1), insn_arg(ip, 2));
+        cell += insn_arg(ip, 0);
+        cell[insn_arg(ip, 1)] += insn_arg(ip, 2);
+        NEXT(4);
+    INSN(bf_insn_add_add):
+        bf_log("cell[%d] += %d; cell[%d] += %d;\n", insn_arg(ip, 0), insn_arg(ip, 1), insn_arg(ip, 2), insn_arg(ip, 3));
+        cell[insn_arg(ip, 0)] += insn_arg(ip, 1);
+        cell[insn_arg(ip, 2)] += insn_arg(ip, 3);
+        NEXT(5);
+    INSN(bf_insn_add_put):
+        cell[insn_arg(ip, 0)] += insn_arg(ip, 1);
+        bf_log("cell[%d] += %d; putchar(%d);\n", insn_arg(ip, 0), insn_arg(ip, 1), cell[insn_arg(ip, 2)]);
+        *io->out++ = cell[insn_arg(ip, 2)];
+        if (io->out == io->out_end) {
+            io->flush(io);
+        }
+        NEXT(4);
+    // These have their own copy of the jump, so it gets its own prediction.
+    INSN(bf_insn_move_start):
+        bf_log("cell += %d; if (%i == 0) {\n    i += %i;\n}\n", insn_arg(ip, 0), cell[insn_arg(ip, 0)], insn_arg(ip, 1));
+        cell += insn_arg(ip, 0);
+        if (*cell == 0) {
+            ip += insn_arg(ip, 1);
+        }
+        NEXT(3);
+    INSN(bf_insn_move_end):
+        bf_log("cell += %d; if (%i != 0) {\n    i += %i;\n}\n", insn_arg(ip, 0), cell[insn_arg(ip, 0)], insn_arg(ip, 1));
+        cell += insn_arg(ip, 0);
+        if (*cell != 0) {
+            ip += insn_arg(ip, 1);
+        }
+        NEXT(3);
+    INSN(bf_insn_add_end):
+        cell[insn_arg(ip, 0)] += insn_arg(ip, 1);
+        bf_log("cell[%d] += %d; if (%i != 0) {\n    i += %i;\n}\n", insn_arg(ip, 0), insn_arg(ip, 1), *cell, insn_arg(ip, 2));
+        if (*cell != 0) {
+            ip += insn_arg(ip, 2);
+        }
+        NEXT(4);
+    INSN(bf_insn_count):
+#ifdef PROFILE
+        ++io->profile_counts[insn_arg_w(ip, 0)];
+#endif
+        NEXT(5);
+    INSN(bf_insn_halt):
+        bf_log("return;\n");
+    }
+stop:
+    io->flush(io);
+#ifdef INTERP_PAIRS
+    print_pairs(pairs);
+    free(pairs);
+#endif
+#ifdef PROFILE
+    finish_profile(program, io);
+#endif
+    free_tape(program, io);
+    dealloc_io(io);
+    return status;
+}
+#undef COUNT_PAIR
+#undef INSN
+#undef DISPATCH
+#undef NEXT
+#undef WIDE
+
+static void release_opcodes(brainfuck_program *restrict program)
+{
+    free(program->code);
 }
 
 #endif // BRAINFUCK_INTERP_H
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2019 easyaspi314
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ */
+
+/// brainfuck-io.h: The buffered I/O and heap tape runtime behind bf_io, shared by the JIT
+/// runner and the interpreter.
+///
+/// '.' and ',' only touch the buffers. When the program reads stdin, refill_input() maps
+/// it if it is a regular file, and otherwise reads it in big chunks. Custom getchar_ptrs
+/// are still called a byte at a time, since they may be interactive.
+#ifndef BRAINFUCK_IO_H
+#define BRAINFUCK_IO_H
+
+#ifndef BRAINFUCK_JIT_C
+#   error "This file is only to be included from brainfuck-jit.c"
+#endif
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <errno.h>
+#   include <unistd.h> // read, lseek
+#   include <sys/mman.h> // mmap
+#   include <sys/stat.h> // fstat
+#   define BF_IO_UNIX 1
+#endif
+
+// What ',' reads at the end of the input.
+static const uint8_t eof_byte = 0xFF;
+
+// Called by the generated code when the output buffer is full, before it reads input,
+// and when it returns.
+static void flush_output(bf_io *io)
+{
+    size_t len = io->out - io->out_buffer;
+    // One locked write instead of a putchar per byte.
+    if (io->putchar_ptr == &putchar) {
+        fwrite(io->out_buffer, 1, len, stdout);
+    } else {
+        for (size_t i = 0; i < len; i++) {
+            io->putchar_ptr(io->out_buffer[i]);
+        }
+    }
+    io->out = io->out_buffer;
+}
+
+#ifdef BF_IO_UNIX
+// Maps the rest of stdin if it is a regular file. Only done once, so after we reach the
+// end of the mapping we fall back to read(), which tells us we are at EOF.
+static bool map_stdin(bf_io *io)
+{
+    struct stat st;
+    if (io->in_map != NULL || fstat(STDIN_FILENO, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+    off_t start = lseek(STDIN_FILENO, 0, SEEK_CUR);
+    if (start < 0 || start >= st.st_size) {
+        return false;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, STDIN_FILENO, 0);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    // Keep the file position in sync, dealloc_io() rewinds it to what we didn't read.
+    lseek(STDIN_FILENO, st.st_size, SEEK_SET);
+    io->in_map = (uint8_t *)map;
+    io->in_map_len = (size_t)st.st_size;
+    io->in = io->in_map + start;
+    io->in_end = io->in_map + st.st_size;
+    return true;
+}
+#endif
+
+// Called by the generated code when ',' runs out of input.
+static void refill_input(bf_io *io)
+{
+    // We are about to block, so the prompt has to go out first.
+    io->flush(io);
+#ifdef BF_IO_UNIX
+    if (io->getchar_ptr == &getchar) {
+        fflush(stdout);
+        if (map_stdin(io)) {
+            return;
+        }
+        ssize_t len;
+        do {
+            len = read(STDIN_FILENO, io->in_buffer, BF_INPUT_BUFFER_SIZE);
+        } while (len < 0 && errno == EINTR);
+        if (len <= 0) {
+            io->in = (uint8_t *)&eof_byte;
+            io->in_end = io->in + 1;
+            return;
+        }
+        io->in = io->in_buffer;
+        io->in_end = io->in_buffer + len;
+        return;
+    }
+#endif
+    // EOF is truncated to 0xFF, same as before.
+    io->in_buffer[0] = (uint8_t)io->getchar_ptr();
+    io->in = io->in_buffer;
+    io->in_end = io->in_buffer + 1;
+}
+
+// Where end_run() goes for the program running on a heap tape on this thread.
+static bf_thread_local jmp_buf *run_escape;
+
+// Ends the program running on this thread with the given status, from anywhere inside
+// it. Whatever it printed so far still goes out.
+static void end_run(bf_io *io, int status)
+{
+    io->flush(io);
+#ifdef HAVE_GUARD_TAPE
+    if (current_tape != NULL) {
+        siglongjmp(current_tape->escape, status);
+    }
+#endif
+    longjmp(*run_escape, status);
+}
+
+// Called by the bounds checks in checked builds, right before the program would leave
+// the tape.
+static void tape_overrun(bf_io *io)
+{
+    end_run(io, BF_RAN_OFF_TAPE);
+}
+
+// Zeroed cells on either side of a heap tape. The vectorized scans read up to a vector
+// past the ends, and in checked builds, a scan that runs off the tape has to stop in
+// here so the check after it can catch it.
+static size_t tape_padding(const brainfuck_program *program)
+{
+    return 64 + (size_t)program->tape_stride;
+}
+
+// Allocates a zeroed tape on the heap. Programs analyze_tape() proved bounded get exactly
+// the cells they use, everything else gets 65536. Returns cell 0, and points the tape
+// fields of io at it.
+static bf_cell *alloc_tape(const brainfuck_program *program, bf_io *io)
+{
+    int32_t min = program->tape_bounded ? program->tape_min : 0;
+    int32_t max = program->tape_bounded ? program->tape_max : 65535;
+    size_t pad = tape_padding(program);
+    bf_cell *tape = (bf_cell *)calloc((size_t)(max - min) + 1 + 2 * pad, sizeof(bf_cell));
+    if (tape == NULL) {
+        return NULL;
+    }
+    io->tape_start = tape + pad;
+    io->tape_end = io->tape_start + (max - min) + 1;
+    return io->tape_start - min;
+}
+
+static void free_tape(const brainfuck_program *program, bf_io *io)
+{
+    free(io->tape_start - tape_padding(program));
+}
+
+#if JIT_MODE != 0
+// Runs the generated code on a fresh tape. Bounded programs get a tape that fits, and
+// checked code needs the bounds it checks against. Everything else runs on the guard
+// page tape if there is one. Returns 0, or the status end_run() was given.
+static int run_on_fresh_tape(const brainfuck_program *program, brainfuck_t fuck, bf_io *io)
+{
+#ifdef HAVE_GUARD_TAPE
+    if (!program->tape_bounded && !BF_CHECKED) {
+        return run_on_tape(fuck, io);
+    }
+#endif
+    bf_cell *cell = alloc_tape(program, io);
+    if (!cell) {
+        return BF_OUT_OF_MEMORY;
+    }
+    jmp_buf escape;
+    int status = setjmp(escape);
+    if (status != 0) {
+        run_escape = NULL;
+        free_tape(program, io);
+        return status;
+    }
+    run_escape = &escape;
+    fuck(cell, io);
+    run_escape = NULL;
+    free_tape(program, io);
+    return 0;
+}
+#endif
+
+// Sets up the I/O state for one run. unbuffered makes every '.' flush.
+static bf_io *alloc_io(int (*putchar_ptr)(int), int (*getchar_ptr)(void), bool unbuffered)
+{
+    bf_io *io = (bf_io *)malloc(sizeof(bf_io));
+    if (io == NULL) {
+        return NULL;
+    }
+    io->out = io->out_buffer;
+    io->out_end = io->out_buffer + (unbuffered ? 1 : BF_OUTPUT_BUFFER_SIZE);
+    io->in = io->in_end = io->in_buffer;
+    io->flush = &flush_output;
+    io->refill = &refill_input;
+    io->getchar_ptr = getchar_ptr;
+    io->putchar_ptr = putchar_ptr;
+    io->tape_start = io->tape_end = NULL;
+    io->tape_error = &tape_overrun;
+    io->in_map = NULL;
+    io->in_map_len = 0;
+#ifdef PROFILE
+    io->profile_counts = NULL;
+#endif
+    return io;
+}
+
+// Frees the I/O state. Whatever we read ahead from a seekable stdin is given back, so
+// the next reader starts where the program stopped.
+static void dealloc_io(bf_io *io)
+{
+#ifdef BF_IO_UNIX
+    if (io->getchar_ptr == &getchar && io->in != &eof_byte && io->in_end > io->in) {
+        lseek(STDIN_FILENO, -(off_t)(io->in_end - io->in), SEEK_CUR);
+    }
+    if (io->in_map != NULL) {
+        munmap(io->in_map, io->in_map_len);
+    }
+#endif
+    free(io);
+}
+
+#endif // BRAINFUCK_IO_H
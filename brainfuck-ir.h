@@ -61,6 +61,18 @@ static int update_copyloop(bf_opcode *restrict program, size_t size)
         return 0;
     }
 
+    // Make sure everything fits in the amount, see copy_mul_factor().
+    for (size_t q = 0; q < nmults; ++q) {
+        if (offsets[q] >= 1 << (31 - COPY_MUL_BITS) || offsets[q] < -(1 << (31 - COPY_MUL_BITS))) {
+            return 0;
+        }
+#if CELL_BITS == 32
+        if (mults[q] >= 1 << (COPY_MUL_BITS - 1) || mults[q] < -(1 << (COPY_MUL_BITS - 1))) {
+            return 0;
+        }
+#endif
+    }
+
     i = 0;
 
     // copy/muls are stored like so:
@@ -70,7 +82,7 @@ static int update_copyloop(bf_opcode *restrict program, size_t size)
         if (mults[q] != 0 && offsets[q] != 0) {
             bf_log("%d += cell * %d\n", offsets[q], mults[q]);
             program[i].op = bf_opcode_copy_mul;
-            program[i].amount = (mults[q] & 0xFF) | (offsets[q] << 8);
+            program[i].amount = (mults[q] & ((1 << COPY_MUL_BITS) - 1)) | (int32_t)((uint32_t)offsets[q] << COPY_MUL_BITS);
             ++i;
         }
     }
@@ -130,4 +142,458 @@ static void write_clear_loop(bf_opcode *restrict start, bf_opcode **restrict out
     start->op = bf_opcode_clear;
     *out = start + 1;
 }
+// Overwrites a scan loop with a scan
+static void write_scan_loop(bf_opcode *restrict start, bf_opcode **restrict out, int32_t stride)
+{
+    start->op = bf_opcode_scan;
+    start->amount = stride;
+    *out = start + 1;
+}
+
+// Moves the pointer update of a basic block into its last move, and rebases the ops
+// after it on the new pointer.
+static void flush_moves(bf_opcode *restrict opcodes, size_t last_move, size_t end, int32_t offset)
+{
+    if (offset == 0) {
+        return;
+    }
+    opcodes[last_move].op = bf_opcode_move;
+    opcodes[last_move].amount = offset;
+    for (size_t i = last_move + 1; i < end; i++) {
+        opcodes[i].offset -= offset;
+    }
+}
+
+/// Optimization: Converts >+>++<. to cell[1] += 1; cell[2] += 2; putchar(cell[1]); cell += 1;
+///
+/// Within a basic block, we keep track of where the pointer would be instead of moving
+/// it, and address the cells relative to it. Blocks end at loops and scans, which is
+/// where we actually move the pointer, with the net amount.
+///
+/// Afterwards, we squeeze out the nops and fix up the jumps. loops is scratch space for
+/// the loop stack. Returns the new length.
+static size_t sink_moves(bf_opcode *restrict opcodes, size_t len, bf_opcode **restrict loops)
+{
+    int32_t offset = 0;
+    size_t last_move = 0, kept = 0;
+    for (size_t i = 0; i < len; i++) {
+        switch (opcodes[i].op) {
+        case bf_opcode_move:
+            offset += opcodes[i].amount;
+            opcodes[i].op = bf_opcode_nop;
+            last_move = i;
+            break;
+        case bf_opcode_add:
+        case bf_opcode_clear:
+        case bf_opcode_copy_mul:
+        case bf_opcode_put:
+        case bf_opcode_get:
+            opcodes[i].offset = offset;
+            break;
+        case bf_opcode_start:
+        case bf_opcode_end:
+        case bf_opcode_scan:
+            flush_moves(opcodes, last_move, i, offset);
+            offset = 0;
+            break;
+        default:
+            break;
+        }
+    }
+    flush_moves(opcodes, last_move, len, offset);
+
+    bf_opcode **loops_iterator = loops;
+    for (size_t i = 0; i < len; i++) {
+        if (opcodes[i].op == bf_opcode_nop) {
+            continue;
+        }
+        bf_opcode *op = &opcodes[kept++];
+        *op = opcodes[i];
+        if (op->op == bf_opcode_start) {
+            *loops_iterator++ = op;
+        } else if (op->op == bf_opcode_end) {
+            bf_opcode *start = *--loops_iterator;
+            start->amount = op - start;
+            op->amount = start - op;
+        }
+    }
+    bf_log("sink_moves: %zu -> %zu opcodes\n", len, kept);
+    return kept;
+}
+// The biggest tape we size to fit. Programs that need more are treated as unbounded.
+#define MAX_BOUNDED_TAPE (1 << 24)
+
+typedef struct {
+    // Where the loop starts, how far its body has moved the pointer so far, and whether
+    // it is still balanced.
+    size_t start;
+    int64_t moved;
+    bool balanced;
+} bf_loop_state;
+
+// Finds the balanced loops: ones whose body moves the pointer by a net zero and only
+// contains balanced loops. Every iteration of them starts on the same cell. Scans are
+// never balanced. Sets balanced[i] for their '['s, and returns true if the whole program
+// is balanced. loops needs room for len + 1 entries.
+static bool find_balanced_loops(const bf_opcode *restrict opcodes, size_t len, bool *restrict balanced, bf_loop_state *restrict loops)
+{
+    // loops[0] is the top level.
+    size_t depth = 0;
+    loops[0].moved = 0;
+    loops[0].balanced = true;
+    for (size_t i = 0; i < len; i++) {
+        switch (opcodes[i].op) {
+        case bf_opcode_move:
+            loops[depth].moved += opcodes[i].amount;
+            break;
+        case bf_opcode_scan:
+            loops[depth].balanced = false;
+            break;
+        case bf_opcode_start:
+            ++depth;
+            loops[depth].start = i;
+            loops[depth].moved = 0;
+            loops[depth].balanced = true;
+            break;
+        case bf_opcode_end: {
+            bool ok = loops[depth].balanced && loops[depth].moved == 0;
+            balanced[loops[depth].start] = ok;
+            --depth;
+            if (!ok) {
+                loops[depth].balanced = false;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return loops[0].balanced;
+}
+
+// Walks a balanced program and finds the lowest and highest cells it touches. Since
+// each loop ends where it started, one pass over the body covers every iteration.
+static void find_tape_range(const bf_opcode *restrict opcodes, size_t len, int64_t *restrict min, int64_t *restrict max)
+{
+    int64_t at = 0;
+    *min = *max = 0;
+    for (size_t i = 0; i < len; i++) {
+        int64_t cell = at + opcodes[i].offset, other = cell;
+        switch (opcodes[i].op) {
+        case bf_opcode_move:
+            at += opcodes[i].amount;
+            continue;
+        case bf_opcode_copy_mul:
+            other = cell + copy_mul_target(opcodes[i].amount);
+            break;
+        case bf_opcode_add:
+        case bf_opcode_clear:
+        case bf_opcode_put:
+        case bf_opcode_get:
+            break;
+        case bf_opcode_start:
+        case bf_opcode_end:
+            cell = other = at;
+            break;
+        default:
+            continue;
+        }
+        *min = cell < *min ? cell : *min;
+        *min = other < *min ? other : *min;
+        *max = cell > *max ? cell : *max;
+        *max = other > *max ? other : *max;
+    }
+}
+
+#ifdef CHECKED
+// Where a loop started, and for balanced ones, what we knew at its '['. Every iteration
+// starts on that cell, and so does the code after the loop.
+typedef struct {
+    size_t start;
+    bool balanced;
+    int64_t known_lo, known_hi;
+} bf_check_loop;
+
+typedef struct {
+    bf_opcode *out;
+    size_t len;
+    // The check covering the code since the last place one had to go, the cells it has
+    // to cover so far, and where the pointer is relative to where it runs.
+    size_t check;
+    int64_t lo, hi;
+    int64_t at;
+    // The cells earlier checks proved are on the tape, relative to the same place. The
+    // tape has no holes, so if two checks passed, everything in between is on it too.
+    // known_lo > known_hi if we don't know anything.
+    int64_t known_lo, known_hi;
+    // The loops we are in.
+    bf_check_loop *loops;
+    size_t depth;
+    // The new loop_spans for perf, or NULL.
+    bf_source_span *spans;
+    size_t spans_len;
+} bf_check_state;
+
+// Starts a check where the pointer is now. If keep_known, what we knew still holds there.
+static void begin_check(bf_check_state *restrict state, bool keep_known)
+{
+    if (keep_known && state->known_lo <= state->known_hi) {
+        state->known_lo -= state->at;
+        state->known_hi -= state->at;
+    } else {
+        state->known_lo = INT64_MAX;
+        state->known_hi = INT64_MIN;
+    }
+    state->check = state->len++;
+    state->out[state->check].op = bf_opcode_check;
+    state->lo = INT64_MAX;
+    state->hi = INT64_MIN;
+    state->at = 0;
+}
+
+static void cover_cell(bf_check_state *restrict state, int64_t offset)
+{
+    int64_t cell = state->at + offset;
+    state->lo = cell < state->lo ? cell : state->lo;
+    state->hi = cell > state->hi ? cell : state->hi;
+}
+
+// Fills in the range of the current check, or drops it if there is nothing new to check.
+// Far away offsets are clamped, so the backends can scale them to bytes. They are off
+// the tape either way.
+static void end_check(bf_check_state *restrict state)
+{
+    bf_opcode *check = &state->out[state->check];
+    if (state->lo > state->hi || (state->known_lo <= state->lo && state->hi <= state->known_hi)) {
+        check->op = bf_opcode_nop;
+        return;
+    }
+    check->amount = (int32_t)(state->lo < -MAX_BOUNDED_TAPE ? -MAX_BOUNDED_TAPE : state->lo);
+    check->offset = (int32_t)(state->hi > MAX_BOUNDED_TAPE ? MAX_BOUNDED_TAPE : state->hi);
+    bf_log("check: cell[%d] to cell[%d]\n", check->amount, check->offset);
+    if (state->known_lo > state->known_hi) {
+        state->known_lo = state->lo;
+        state->known_hi = state->hi;
+    } else {
+        state->known_lo = state->lo < state->known_lo ? state->lo : state->known_lo;
+        state->known_hi = state->hi > state->known_hi ? state->hi : state->known_hi;
+    }
+}
+
+// Copies op, with a check before it if it has to go there.
+static void check_opcode(bf_check_state *restrict state, bf_opcode op, bool balanced)
+{
+    switch (op.op) {
+    case bf_opcode_move:
+        state->at += op.amount;
+        break;
+    case bf_opcode_add:
+    case bf_opcode_clear:
+        cover_cell(state, op.offset);
+        break;
+    case bf_opcode_copy_mul:
+        cover_cell(state, op.offset);
+        cover_cell(state, op.offset + copy_mul_target(op.amount));
+        break;
+    case bf_opcode_put:
+    case bf_opcode_get:
+        cover_cell(state, op.offset);
+        end_check(state);
+        state->out[state->len++] = op;
+        begin_check(state, true);
+        return;
+    case bf_opcode_scan:
+        cover_cell(state, 0);
+        end_check(state);
+        state->out[state->len++] = op;
+        begin_check(state, false);
+        return;
+    case bf_opcode_start: {
+        cover_cell(state, 0);
+        end_check(state);
+        bf_check_loop *loop = &state->loops[state->depth++];
+        loop->start = state->len;
+        loop->balanced = balanced;
+        state->out[state->len++] = op;
+        begin_check(state, balanced);
+        loop->known_lo = state->known_lo;
+        loop->known_hi = state->known_hi;
+        return;
+    }
+    case bf_opcode_end: {
+        cover_cell(state, 0);
+        end_check(state);
+        bf_check_loop *loop = &state->loops[--state->depth];
+        state->out[loop->start].amount = (int32_t)(state->len - loop->start);
+        op.amount = (int32_t)(loop->start - state->len);
+        state->out[state->len++] = op;
+        begin_check(state, false);
+        if (loop->balanced) {
+            state->known_lo = loop->known_lo;
+            state->known_hi = loop->known_hi;
+        }
+        return;
+    }
+    default:
+        break;
+    }
+    state->out[state->len++] = op;
+}
+
+// How many copy_muls start at opcodes[i] that share a source, if a clear of that source
+// comes right after them.
+static size_t copy_mul_run(const bf_opcode *restrict opcodes, size_t i, size_t len)
+{
+    size_t n = 0;
+    while (i + n < len && opcodes[i + n].op == bf_opcode_copy_mul && opcodes[i + n].offset == opcodes[i].offset) {
+        ++n;
+    }
+    if (i + n == len || opcodes[i + n].op != bf_opcode_clear || opcodes[i + n].offset != opcodes[i].offset) {
+        return 0;
+    }
+    return n;
+}
+
+/// Checked builds: Bounds checks the programs analyze_tape() couldn't prove bounded.
+///
+/// A check has to fail right before the program leaves the tape, and not before anything
+/// it would have done first that we can see. So one check covers a stretch of code that
+/// is sure to run once it starts: it ends at each loop, scan, '.' and ','. Within it, the
+/// pointer only moves by amounts we know.
+///
+/// Checks are dropped when earlier ones already covered their cells. We keep track of
+/// what we know across balanced loops, since every iteration of those and the code after
+/// them start on the same cell. Unbalanced loops and scans move the pointer by amounts we
+/// don't know, so we start over after them.
+///
+/// A copy loop only touches its targets if its source isn't 0, so it goes back to being
+/// a loop that runs once, with the check for its targets inside. perf gets a span without
+/// a place in the source for it, so the loops after it keep their names.
+/// Returns false if we are out of memory.
+static bool insert_bounds_checks(brainfuck_program *restrict program, const bool *restrict balanced)
+{
+    const bf_opcode *opcodes = program->opcodes;
+    size_t len = program->opcodes_len;
+    bf_check_state state;
+    // At most one check after each opcode, one at the start, and a move, start, end and
+    // move back around each copy loop, which is at least two opcodes.
+    state.out = (bf_opcode *)calloc(4 * len + 1, sizeof(bf_opcode));
+    state.loops = (bf_check_loop *)malloc((len + 1) * sizeof(bf_check_loop));
+    state.spans = NULL;
+    if (program->loop_spans) {
+        state.spans = (bf_source_span *)malloc((program->loop_spans_len + len + 1) * sizeof(bf_source_span));
+    }
+    if (!state.out || !state.loops || (program->loop_spans && !state.spans)) {
+        free(state.out);
+        free(state.loops);
+        free(state.spans);
+        return false;
+    }
+    state.len = 0;
+    state.depth = 0;
+    state.spans_len = 0;
+    size_t loops = 0;
+    begin_check(&state, false);
+    for (size_t i = 0; i < len; i++) {
+        bf_opcode op = opcodes[i];
+        size_t copies = op.op == bf_opcode_copy_mul ? copy_mul_run(opcodes, i, len) : 0;
+        if (copies == 0) {
+            if (op.op == bf_opcode_start && state.spans) {
+                state.spans[state.spans_len++] = program->loop_spans[loops++];
+            }
+            check_opcode(&state, op, balanced[i]);
+            continue;
+        }
+        // Move to the source, so the loop can test it, and back afterwards.
+        bf_opcode loop_op;
+        memset(&loop_op, 0, sizeof(loop_op));
+        int32_t source = op.offset;
+        if (source != 0) {
+            loop_op.op = bf_opcode_move;
+            loop_op.amount = source;
+            check_opcode(&state, loop_op, false);
+        }
+        loop_op.op = bf_opcode_start;
+        loop_op.amount = 0;
+        if (state.spans) {
+            state.spans[state.spans_len].start = UINT32_MAX;
+            state.spans[state.spans_len++].end = UINT32_MAX;
+        }
+        check_opcode(&state, loop_op, true);
+        for (size_t j = i; j <= i + copies; j++) {
+            op = opcodes[j];
+            op.offset = 0;
+            check_opcode(&state, op, false);
+        }
+        loop_op.op = bf_opcode_end;
+        check_opcode(&state, loop_op, true);
+        if (source != 0) {
+            loop_op.op = bf_opcode_move;
+            loop_op.amount = -source;
+            check_opcode(&state, loop_op, false);
+        }
+        i += copies;
+    }
+    end_check(&state);
+    free(state.loops);
+    bf_log("insert_bounds_checks: %zu -> %zu opcodes\n", len, state.len);
+    free(program->opcodes);
+    program->opcodes = state.out;
+    program->opcodes_len = state.len;
+    if (state.spans) {
+        free(program->loop_spans);
+        program->loop_spans = state.spans;
+        program->loop_spans_len = state.spans_len;
+    }
+    return true;
+}
+#endif // CHECKED
+
+/// Tape bounds analysis: Works out which cells the program can reach.
+///
+/// If every loop is balanced, we know exactly which cells the program touches, and the
+/// runner gives it a tape that fits, which is usually small enough for L1. Otherwise it
+/// gets the default tape, and checked builds insert bounds checks where we lost track.
+/// Both tapes start at cell 0, so a program that goes below it isn't bounded either.
+/// Returns false if we are out of memory.
+static bool analyze_tape(brainfuck_program *restrict program)
+{
+    size_t len = program->opcodes_len;
+    bool *balanced = (bool *)calloc(len + 1, sizeof(bool));
+    bf_loop_state *loops = (bf_loop_state *)malloc((len + 1) * sizeof(bf_loop_state));
+    if (!balanced || !loops) {
+        free(balanced);
+        free(loops);
+        return false;
+    }
+    program->tape_bounded = false;
+    program->tape_min = 0;
+    program->tape_max = 0;
+    program->tape_stride = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (program->opcodes[i].op == bf_opcode_scan) {
+            int32_t stride = abs(program->opcodes[i].amount);
+            program->tape_stride = stride > program->tape_stride ? stride : program->tape_stride;
+        }
+    }
+    if (find_balanced_loops(program->opcodes, len, balanced, loops)) {
+        int64_t min, max;
+        find_tape_range(program->opcodes, len, &min, &max);
+        if (min >= 0 && max < MAX_BOUNDED_TAPE) {
+            program->tape_bounded = true;
+            program->tape_min = (int32_t)min;
+            program->tape_max = (int32_t)max;
+            bf_log("analyze_tape: cells %d to %d\n", program->tape_min, program->tape_max);
+        }
+    }
+    free(loops);
+#ifdef CHECKED
+    if (!program->tape_bounded && !insert_bounds_checks(program, balanced)) {
+        free(balanced);
+        return false;
+    }
+#endif
+    free(balanced);
+    return true;
+}
 #endif // BRAINFUCK_IR_H
@@ -20,234 +20,606 @@
 #   error "This is for aarch64 only!"
 #endif
 
-// sub + strb + blx/subs/adds + ldrb = 20 bytes
-#define MAX_INSN_LEN 20
-// size of init[]
-#define INIT_LEN 24
-// size of cleanup[]
-#define CLEANUP_LEN 12
+// copy_mul with both cells out of ldurb range = 56 bytes
+#define MAX_INSN_LEN 56
+// size of init[], including the stubs
+#define INIT_LEN 108
+// Where the flush and refill stubs start in init[], in instructions
+#define FLUSH_STUB_POS 10
+#define REFILL_STUB_POS 18
+// size of cleanup[] and the flush call
+#define CLEANUP_LEN 36
 
 typedef uint32_t raw_opcode;
 
+// Which calling convention the generated code follows. Part of the code cache key.
+#define JIT_ABI "aarch64-aapcs64"
+
+// strb + tst + b.eq + 3 for the address + mov + ldrb + cbnz = 36 bytes
+#define MAX_SCAN_LEN 36
+// Two 6 instruction compares and the call, see write_check()
+#define MAX_CHECK_LEN 64
+// -DPROFILE: Two 32-bit constants and 5 instructions, see write_profile_count()
+#define MAX_PROFILE_LEN 36
+
+// The loads and stores for each cell width. The pre-indexed form is ldur with bits 10
+// and 11 set.
+#if CELL_BITS == 8
+#   define CELL_SUFFIX "b"
+#   define CELL_LDUR 0x38400000
+#   define CELL_STUR 0x38000000
+#   define CELL_LDR 0x39400000
+#   define CELL_STR 0x39000000
+// tst w0, #0xFF
+#   define CELL_TEST 0x72001c1f
+#   define CELL_TEST_ASM "tst     w0, #0xFF"
+#elif CELL_BITS == 16
+#   define CELL_SUFFIX "h"
+#   define CELL_LDUR 0x78400000
+#   define CELL_STUR 0x78000000
+#   define CELL_LDR 0x79400000
+#   define CELL_STR 0x79000000
+// tst w0, #0xFFFF
+#   define CELL_TEST 0x72003c1f
+#   define CELL_TEST_ASM "tst     w0, #0xFFFF"
+#else
+#   define CELL_SUFFIX ""
+#   define CELL_LDUR 0xb8400000
+#   define CELL_STUR 0xb8000000
+#   define CELL_LDR 0xb9400000
+#   define CELL_STR 0xb9000000
+// tst w0, w0
+#   define CELL_TEST 0x6a00001f
+#   define CELL_TEST_ASM "tst     w0, w0"
+#endif
+
+// Whether w0 is exactly the current cell. Adds can leave junk above a byte or halfword
+// cell, so the loop tests have to tst the low bits, but after a load or a mov they can
+// cbz/cbnz on w0 directly. 32-bit cells are always exact.
+static bf_thread_local bool w0_exact;
+
+// We don't use any optional instructions.
+static uint32_t jit_cpu_features(void)
+{
+    return 0;
+}
+
 // Writes the initialization code for our JIT.
+//
+// x19 is the cell pointer, x20 is the bf_io struct, x21 and x22 are io->out and
+// io->out_end, and x23 and x24 are io->in and io->in_end. w0 is a working copy of the
+// current cell, which only goes back to memory when we move. After the prologue we jump
+// over the flush and refill stubs, tiny functions that sync the registers with io around
+// a call to io->flush or io->refill.
 static void write_init_code(uint32_t *restrict out, size_t *restrict pos)
 {
     const uint32_t init[] = {
-        // push x19, x20, x21, and lr (x30) to the stack
-        // stp x19, x20, [sp, #-16]!
-        0xa9bf53f3,
-        // stp x21, x30, [sp, #-16]!
-        0xa9bf7bf5,
+        // push x19-x24 and lr (x30) to the stack
+        // stp x19, x20, [sp, #-64]!
+        0xa9bc53f3,
+        // stp x21, x22, [sp, #16]
+        0xa9015bf5,
+        // stp x23, x24, [sp, #32]
+        0xa90263f7,
+        // str x30, [sp, #48]
+        0xf9001bfe,
 
-        // mov x19, w0 // x19 = cells
+        // mov x19, x0 // x19 = cells
         0xaa0003f3,
-        // mov x20, x1 // x20 = getchar
+        // mov x20, x1 // x20 = io
         0xaa0103f4,
-        // mov x21, r2 // x21 = putchar
-        0xaa0203f5,
-        // mov w0, #0
-        0x52800000,
+        // ldp x21, x22, [x20] // x21 = io->out, x22 = io->out_end
+        0xa9405a95,
+        // ldp x23, x24, [x20, #16] // x23 = io->in, x24 = io->in_end
+        0xa9416297,
+        // ldr w0, [x19] // w0 = the current cell
+        CELL_LDR | (19 << 5),
+        // b .Lstart
+        0x14000012,
+
+        // .Lflush:
+        // stp x0, x30, [sp, #-16]!
+        0xa9bf7be0,
+        // str x21, [x20]
+        0xf9000295,
+        // mov x0, x20
+        0xaa1403e0,
+        // ldr x16, [x20, #32] // io->flush
+        0xf9401290,
+        // blr x16
+        0xd63f0200,
+        // ldr x21, [x20]
+        0xf9400295,
+        // ldp x0, x30, [sp], #16
+        0xa8c17be0,
+        // ret
+        0xd65f03c0,
+
+        // .Lrefill:
+        // stp x0, x30, [sp, #-16]!
+        0xa9bf7be0,
+        // str x21, [x20]
+        0xf9000295,
+        // mov x0, x20
+        0xaa1403e0,
+        // ldr x16, [x20, #40] // io->refill
+        0xf9401690,
+        // blr x16
+        0xd63f0200,
+        // ldr x21, [x20]
+        0xf9400295,
+        // ldp x23, x24, [x20, #16]
+        0xa9416297,
+        // ldp x0, x30, [sp], #16
+        0xa8c17be0,
+        // ret
+        0xd65f03c0,
+        // .Lstart:
     };
     memcpy(out + (*pos), init, sizeof(init));
     *pos += sizeof(init) / sizeof(uint32_t);
+    w0_exact = true;
     bf_log(
         "      .text\n"
         "      .globl fuck\n"
         "      .type fuck,%%function\n"
         "fuck:\n"
-        "      stp     x19, x20, [sp, #-16]!\n"
-        "      stp     x21, x30, [sp, #-16]!\n"
+        "      stp     x19, x20, [sp, #-64]!\n"
+        "      stp     x21, x22, [sp, #16]\n"
+        "      stp     x23, x24, [sp, #32]\n"
+        "      str     x30, [sp, #48]\n"
         "      mov     x19, x0 // x19 = cells\n"
-        "      mov     x20, x1 // x20 = &getchar\n"
-        "      mov     x21, x2 // x21 = &putchar\n"
-        "      mov     w0, #0 // start with an initial zero\n"
+        "      mov     x20, x1 // x20 = io\n"
+        "      ldp     x21, x22, [x20] // x21 = io->out, x22 = io->out_end\n"
+        "      ldp     x23, x24, [x20, #16] // x23 = io->in, x24 = io->in_end\n"
+        "      ldr" CELL_SUFFIX "    w0, [x19]\n"
+        "      b       .Lstart\n"
+        ".Lflush:\n"
+        "      stp     x0, x30, [sp, #-16]!\n"
+        "      str     x21, [x20]\n"
+        "      mov     x0, x20\n"
+        "      ldr     x16, [x20, #32] // io->flush\n"
+        "      blr     x16\n"
+        "      ldr     x21, [x20]\n"
+        "      ldp     x0, x30, [sp], #16\n"
+        "      ret\n"
+        ".Lrefill:\n"
+        "      stp     x0, x30, [sp, #-16]!\n"
+        "      str     x21, [x20]\n"
+        "      mov     x0, x20\n"
+        "      ldr     x16, [x20, #40] // io->refill\n"
+        "      blr     x16\n"
+        "      ldr     x21, [x20]\n"
+        "      ldp     x23, x24, [x20, #16]\n"
+        "      ldp     x0, x30, [sp], #16\n"
+        "      ret\n"
+        ".Lstart:\n"
     );
 }
 
+// Writes a call to one of the stubs in init[].
+static void write_stub_call(size_t stub, uint32_t *restrict out, size_t *restrict pos)
+{
+    bf_log("      bl      %s\n", stub == FLUSH_STUB_POS ? ".Lflush" : ".Lrefill");
+    out[*pos] = 0x94000000 | ((uint32_t)((int32_t)stub - (int32_t)*pos) & ((1 << 26) - 1));
+    ++*pos;
+}
+
 // Writes the cleanup code for our JIT.
 static void write_cleanup_code(uint32_t *restrict out, size_t *restrict pos)
 {
+    // Anything left in the buffer goes out before we return.
+    write_stub_call(FLUSH_STUB_POS, out, pos);
+    // Hands back io->in and the current cell, and returns the cell pointer.
     const uint32_t cleanup[] = {
-        // ldp x21, x30, [sp], #16
-        0xa8c17bf5,
-        // ldp x19, x20, [sp], #16
-        0xa8c153f3,
+        // str x23, [x20, #16]
+        0xf9000a97,
+        // str w0, [x19]
+        CELL_STR | (19 << 5),
+        // mov x0, x19
+        0xaa1303e0,
+        // ldp x21, x22, [sp, #16]
+        0xa9415bf5,
+        // ldp x23, x24, [sp, #32]
+        0xa94263f7,
+        // ldr x30, [sp, #48]
+        0xf9401bfe,
+        // ldp x19, x20, [sp], #64
+        0xa8c453f3,
         // ret
         0xd65f03c0,
     };
     memcpy(out + (*pos), cleanup, sizeof(cleanup));
     *pos += sizeof(cleanup) / sizeof(uint32_t);
     bf_log(
-        "      ldp     x21, x30, [sp], #16\n"
-        "      ldp     x19, x20, [sp], #16\n"
+        "      str     x23, [x20, #16]\n"
+        "      str" CELL_SUFFIX "    w0, [x19]\n"
+        "      mov     x0, x19\n"
+        "      ldp     x21, x22, [sp, #16]\n"
+        "      ldp     x23, x24, [sp, #32]\n"
+        "      ldr     x30, [sp, #48]\n"
+        "      ldp     x19, x20, [sp], #64\n"
         "      ret\n"
     );
 }
 
-// Returns the opcode for add x1, x1, w0, lsl #log2(val&0xff) if val & 0xff
+// Returns the opcode for add x1, x1, wSource, lsl #log2(val&0xff) if val & 0xff
 // is a power of 2, or zero if it isn't.
 //
 // add x1, x1, w0, lsl #2
 // x1 = x1 + (w0 << 2);
-static inline uint32_t get_shift_add_insn(int32_t val)
+static inline uint32_t get_shift_add_insn(int32_t val, uint32_t source)
 {
     switch (val) {
         case -1: // -1 - negate
-            bf_log("      sub     w1, w1, w0\n");
-            return 0x4b000021;
+            bf_log("      sub     w1, w1, w%u\n", source);
+            return 0x4b000021 | (source << 16);
         case -2:
-            bf_log("      sub     w1, w1, w0, lsl #1\n");
-            return 0x4b000421;
+            bf_log("      sub     w1, w1, w%u, lsl #1\n", source);
+            return 0x4b000421 | (source << 16);
         case -4:
-            bf_log("      sub     w1, w1, w0, lsl #2\n");
-            return 0x4b000821;
+            bf_log("      sub     w1, w1, w%u, lsl #2\n", source);
+            return 0x4b000821 | (source << 16);
         case -8:
-            bf_log("      sub     w1, w1, w0, lsl #3\n");
-            return 0x4b000c21;
+            bf_log("      sub     w1, w1, w%u, lsl #3\n", source);
+            return 0x4b000c21 | (source << 16);
         case -16: // 16
-            bf_log("      sub     w1, w1, w0, lsl #4\n");
-            return 0x4b001021;
+            bf_log("      sub     w1, w1, w%u, lsl #4\n", source);
+            return 0x4b001021 | (source << 16);
         case -32: // 32
-            bf_log("      sub     w1, w1, w0, lsl #5\n");
-            return 0x4b001421;
+            bf_log("      sub     w1, w1, w%u, lsl #5\n", source);
+            return 0x4b001421 | (source << 16);
         case -64: // 64
-            bf_log("      sub     w1, w1, w0, lsl #6\n");
-            return 0x4b001821;
+            bf_log("      sub     w1, w1, w%u, lsl #6\n", source);
+            return 0x4b001821 | (source << 16);
 
         case 1 << 0: // 1 - normal add insn
-            bf_log("      add     w1, w1, w0\n");
-            return 0x0b000021;
+            bf_log("      add     w1, w1, w%u\n", source);
+            return 0x0b000021 | (source << 16);
         case 1 << 1: // 2
-            bf_log("      add     w1, w1, w0, lsl #1\n");
-            return 0x0b000421;
+            bf_log("      add     w1, w1, w%u, lsl #1\n", source);
+            return 0x0b000421 | (source << 16);
         case 1 << 2: // 4
-            bf_log("      add     w1, w1, w0, lsl #2\n");
-            return 0x0b000821;
+            bf_log("      add     w1, w1, w%u, lsl #2\n", source);
+            return 0x0b000821 | (source << 16);
         case 1 << 3: // 8
-            bf_log("      add     w1, w1, w0, lsl #3\n");
-            return 0x0b000c21;
+            bf_log("      add     w1, w1, w%u, lsl #3\n", source);
+            return 0x0b000c21 | (source << 16);
         case 1 << 4: // 16
-            bf_log("      add     w1, w1, w0, lsl #4\n");
-            return 0x0b001021;
+            bf_log("      add     w1, w1, w%u, lsl #4\n", source);
+            return 0x0b001021 | (source << 16);
         case 1 << 5: // 32
-            bf_log("      add     w1, w1, w0, lsl #5\n");
-            return 0x0b001421;
+            bf_log("      add     w1, w1, w%u, lsl #5\n", source);
+            return 0x0b001421 | (source << 16);
         case 1 << 6: // 64
-            bf_log("      add     w1, w1, w0, lsl #6\n");
-            return 0x0b001821;
+            bf_log("      add     w1, w1, w%u, lsl #6\n", source);
+            return 0x0b001821 | (source << 16);
         default:
             return 0;
     }
 }
 
+// Puts the address of the cell at x19 + offset in x16.
+static void write_cell_address(int32_t offset, uint32_t *restrict out, size_t *restrict pos)
+{
+    offset *= CELL_BYTES;
+    if (offset >= 0 && offset <= 4095) {
+        bf_log("      add     x16, x19, #%i\n", offset);
+        out[(*pos)++] = 0x91000270 | ((uint32_t)offset << 10);
+        return;
+    }
+    if (offset < 0 && offset >= -4095) {
+        bf_log("      sub     x16, x19, #%i\n", -offset);
+        out[(*pos)++] = 0xd1000270 | ((uint32_t)-offset << 10);
+        return;
+    }
+    bf_log("      movz    w17, #%u\n", (uint32_t)offset & 0xFFFF);
+    out[(*pos)++] = 0x52800011 | (((uint32_t)offset & 0xFFFF) << 5);
+    bf_log("      movk    w17, #%u, lsl #16\n", (uint32_t)offset >> 16);
+    out[(*pos)++] = 0x72a00011 | (((uint32_t)offset >> 16) << 5);
+    bf_log("      add     x16, x19, w17, sxtw\n");
+    out[(*pos)++] = 0x8b31c270;
+}
+
+// Loads or stores wN from the cell at x19 + offset. The current cell lives in w0, so
+// this is only for the others. Offsets out of ldurb/sturb range go through x16.
+static void access_cell(bool store, uint32_t reg, int32_t offset, uint32_t *restrict out, size_t *restrict pos)
+{
+    int32_t bytes = offset * CELL_BYTES;
+    if (bytes >= -256 && bytes <= 255) {
+        bf_log("      %s" CELL_SUFFIX "   w%u, [x19, #%i]\n", store ? "stur" : "ldur", reg, bytes);
+        out[(*pos)++] = (store ? CELL_STUR : CELL_LDUR) | ((bytes & ((1 << 9) - 1)) << 12) | (19 << 5) | reg;
+        return;
+    }
+    write_cell_address(offset, out, pos);
+    bf_log("      %s" CELL_SUFFIX "    w%u, [x16]\n", store ? "str" : "ldr", reg);
+    out[(*pos)++] = (store ? CELL_STR : CELL_LDR) | (16 << 5) | reg;
+}
+
+// Moves x19 by amount cells and loads the new cell into w0.
+static void write_move(int32_t amount, uint32_t *restrict out, size_t *restrict pos)
+{
+    int32_t bytes = amount * CELL_BYTES;
+    if (bytes >= -256 && bytes <= 255) {
+        bf_log("      ldr" CELL_SUFFIX "    w0, [x19, #%i]!\n", bytes);
+        out[(*pos)++] = CELL_LDUR | 0xc00 | ((bytes & ((1 << 9) - 1)) << 12) | (19 << 5);
+        return;
+    }
+    // rare but possible
+    write_cell_address(amount, out, pos);
+    bf_log("      mov     x19, x16\n");
+    out[(*pos)++] = 0xaa1003f3;
+    bf_log("      ldr" CELL_SUFFIX "    w0, [x19]\n");
+    out[(*pos)++] = CELL_LDR | (19 << 5);
+}
+
+// Adds amount to wN, using w2 if it doesn't fit in an immediate.
+static void write_add(uint32_t reg, int32_t amount, uint32_t *restrict out, size_t *restrict pos)
+{
+    // Only the bits that fit in a cell matter.
+    uint32_t value = (uint32_t)(amount > 0 ? amount : -amount) & CELL_MASK;
+    if (value == 0) {
+        return;
+    }
+    if (value <= 4095) {
+        bf_log("      %s     w%u, w%u, #%u\n", amount > 0 ? "add" : "sub", reg, reg, value);
+        out[(*pos)++] = (amount > 0 ? 0x11000000 : 0x51000000) | (value << 10) | (reg << 5) | reg;
+        return;
+    }
+    bf_log("      movz    w2, #%u\n", value & 0xFFFF);
+    out[(*pos)++] = 0x52800002 | ((value & 0xFFFF) << 5);
+    if (value >> 16) {
+        bf_log("      movk    w2, #%u, lsl #16\n", value >> 16);
+        out[(*pos)++] = 0x72a00002 | ((value >> 16) << 5);
+    }
+    bf_log("      %s     w%u, w%u, w2\n", amount > 0 ? "add" : "sub", reg, reg);
+    out[(*pos)++] = (amount > 0 ? 0x0b020000 : 0x4b020000) | (reg << 5) | reg;
+}
+
+// Checked builds: Calls io->tape_error unless cells lo to hi are within io->tape_start
+// and io->tape_end. The output pointer is synced first so it can flush.
+static void write_check(int32_t lo, int32_t hi, uint32_t *restrict out, size_t *restrict pos)
+{
+    write_cell_address(lo, out, pos);
+    bf_log("      ldr     x17, [x20, #64] // io->tape_start\n");
+    out[(*pos)++] = 0xf9402291;
+    bf_log("      cmp     x16, x17\n");
+    out[(*pos)++] = 0xeb11021f;
+    bf_log("      b.lo    1f\n");
+    size_t low_jump = (*pos)++;
+    write_cell_address(hi, out, pos);
+    bf_log("      ldr     x17, [x20, #72] // io->tape_end\n");
+    out[(*pos)++] = 0xf9402691;
+    bf_log("      cmp     x16, x17\n");
+    out[(*pos)++] = 0xeb11021f;
+    bf_log("      b.lo    2f\n");
+    out[(*pos)++] = 0x54000003 | (5 << 5);
+    out[low_jump] = 0x54000003 | (((*pos - low_jump) & ((1 << 19) - 1)) << 5);
+    bf_log("1:\n");
+    bf_log("      str     x21, [x20]\n");
+    out[(*pos)++] = 0xf9000295;
+    bf_log("      mov     x0, x20\n");
+    out[(*pos)++] = 0xaa1403e0;
+    bf_log("      ldr     x16, [x20, #80] // io->tape_error\n");
+    out[(*pos)++] = 0xf9402a90;
+    bf_log("      blr     x16\n");
+    out[(*pos)++] = 0xd63f0200;
+    bf_log("2:\n");
+}
+
+#ifdef PROFILE
+// -DPROFILE: Puts value in w17, zero extended.
+static void write_mov_w17(uint32_t value, uint32_t *restrict out, size_t *restrict pos)
+{
+    bf_log("      movz    w17, #%u\n", value & 0xFFFF);
+    out[(*pos)++] = 0x52800011 | ((value & 0xFFFF) << 5);
+    if (value >> 16) {
+        bf_log("      movk    w17, #%u, lsl #16\n", value >> 16);
+        out[(*pos)++] = 0x72a00011 | ((value >> 16) << 5);
+    }
+}
+
+// -DPROFILE: Adds one to io->profile_counts[site], with x16 and x17.
+static void write_profile_count(uint32_t site, uint32_t *restrict out, size_t *restrict pos)
+{
+    write_mov_w17((uint32_t)offsetof(bf_io, profile_counts), out, pos);
+    bf_log("      ldr     x16, [x20, x17] // io->profile_counts\n");
+    out[(*pos)++] = 0xf8716a90;
+    write_mov_w17(site, out, pos);
+    bf_log("      add     x16, x16, x17, lsl #3\n");
+    out[(*pos)++] = 0x8b110e10;
+    bf_log("      ldr     x17, [x16]\n");
+    out[(*pos)++] = 0xf9400211;
+    bf_log("      add     x17, x17, #1\n");
+    out[(*pos)++] = 0x91000631;
+    bf_log("      str     x17, [x16]\n");
+    out[(*pos)++] = 0xf9000211;
+}
+#endif
+
 static void compile_opcode(bf_opcode *restrict opcode, uint32_t *restrict out, size_t *restrict pos)
 {
+#ifdef PROFILE
+    // Loops count at the top of their body, the ones we turned into something else
+    // count here.
+    if (opcode->site != 0 && opcode->op != bf_opcode_start) {
+        write_profile_count(opcode->site - 1, out, pos);
+    }
+#endif
     if (opcode->op == bf_opcode_nop)
         return;
     switch (opcode->op) {
     case bf_opcode_add:
-        if (opcode->amount > 0) {
-            bf_log("      add     w0, w0, #%i\n", opcode->amount & 0xff);
-            out[(*pos)++] = 0x11000000 | ((opcode->amount & 0xff) << 10);
-        } else if (opcode->amount < 0) {
-            bf_log("      sub     w0, w0, #%i\n", (-opcode->amount) & 0xff);
-            out[(*pos)++] = 0x51000000 | ((-opcode->amount & 0xff) << 10);
+        if (opcode->offset != 0) {
+            // Not the current cell, so we do it in memory
+            access_cell(false, 1, opcode->offset, out, pos);
+            write_add(1, opcode->amount, out, pos);
+            access_cell(true, 1, opcode->offset, out, pos);
+        } else {
+            write_add(0, opcode->amount, out, pos);
+            w0_exact = CELL_BITS == 32;
         }
         break;
     case bf_opcode_move:
         if (opcode->amount == 0)
             break;
-        bf_log("      strb    w0, [x19]\n");
+        bf_log("      str" CELL_SUFFIX "    w0, [x19]\n");
         // Save our working copy
-        out[(*pos)++] = 0x39000260;
-        // rare but possible
-        if (opcode->amount > 255 || opcode->amount < -256) {
-            if (opcode->amount > 0) {
-                bf_log("     add     x19, x19, #%i\n", opcode->amount);
-                out[(*pos)++] = 0x91000273 | ((opcode->amount & 0xFFF) << 10);
-            } else {
-                bf_log("     sub     x19, x19, #%i\n", -opcode->amount);
-                out[(*pos)++] = 0xd1000273 | ((-opcode->amount & 0xFFF) << 10);
-            }
-            bf_log("      ldrb    w0, [x19]\n");
-            out[(*pos)++] = 0x39400260;
-        } else {
-            bf_log("      ldrb    w0, [x19, #%i]!\n", opcode->amount);
-            out[(*pos)++] = 0x38400e60 | ((opcode->amount & ((1 << 9) - 1)) << 12);
-        }
+        out[(*pos)++] = CELL_STR | (19 << 5);
+        write_move(opcode->amount, out, pos);
+        w0_exact = true;
         break;
-    case bf_opcode_put:
-        // Avoid redundant store
-        if (*pos < 1 + INIT_LEN / 4 || opcode[-1].op != bf_opcode_move) {
-            bf_log("      strb    w0, [x19]\n");
-            out[(*pos)++] = 0x39000260;
+    case bf_opcode_put: {
+        // Append the cell to the buffer, and flush it when it fills up.
+        uint32_t reg = 0;
+        if (opcode->offset != 0) {
+            reg = 1;
+            access_cell(false, reg, opcode->offset, out, pos);
         }
-        bf_log("      blr     x20\n");
-        out[(*pos)++] = 0xd63f0280;
-        bf_log("      ldrb    w0, [x19]\n");
-        out[(*pos)++] = 0x39400260;
+        bf_log("      strb    w%u, [x21], #1\n", reg);
+        out[(*pos)++] = 0x380016a0 | reg;
+        bf_log("      cmp     x21, x22\n");
+        out[(*pos)++] = 0xeb1602bf;
+        bf_log("      b.lo    1f\n");
+        out[(*pos)++] = 0x54000043;
+        write_stub_call(FLUSH_STUB_POS, out, pos);
+        bf_log("1:\n");
         break;
-    case bf_opcode_get:
-        bf_log("      blr     x21\n");
-        out[(*pos)++] = 0xd63f02a0;
+    }
+    case bf_opcode_get: {
+        // Take the next byte from the input buffer, and refill it if it is empty.
+        bf_log("      cmp     x23, x24\n");
+        out[(*pos)++] = 0xeb1802ff;
+        bf_log("      b.lo    1f\n");
+        out[(*pos)++] = 0x54000043;
+        write_stub_call(REFILL_STUB_POS, out, pos);
+        bf_log("1:\n");
+        uint32_t reg = opcode->offset != 0 ? 1 : 0;
+        bf_log("      ldrb    w%u, [x23], #1\n", reg);
+        out[(*pos)++] = 0x384016e0 | reg;
+        if (opcode->offset != 0) {
+            access_cell(true, reg, opcode->offset, out, pos);
+        } else {
+            w0_exact = true;
+        }
         break;
+    }
     case bf_opcode_start:
-        bf_log("      tst     w0, #0xFF\n");
-        out[(*pos)++] = 0x72001c1f;
-        bf_log("      b.eq    <tbd>\n");
-
-        *pos += 1; // skip beq
-        opcode->amount = (int32_t)(*pos);
+        // The placeholder is the branch without its offset, so the end can tell which
+        // one it was.
+        if (w0_exact) {
+            bf_log("      cbz     w0, <tbd>\n");
+            out[(*pos)++] = 0x34000000;
+        } else {
+            bf_log("      " CELL_TEST_ASM "\n");
+            out[(*pos)++] = CELL_TEST;
+            bf_log("      b.eq    <tbd>\n");
+            out[(*pos)++] = 0x54000000;
+        }
+        {
+            // Line the body up with nops, see loop_padding().
+            size_t pad = loop_padding(opcode, *pos * sizeof(uint32_t)) / sizeof(uint32_t);
+            opcode->amount = (int32_t)(*pos);
+            opcode->offset = (int32_t)pad;
+            for (size_t i = 0; i < pad; i++) {
+                bf_log("      nop\n");
+                out[(*pos)++] = 0xd503201f;
+            }
+        }
+#ifdef PROFILE
+        if (opcode->site != 0) {
+            write_profile_count(opcode->site - 1, out, pos);
+        }
+#endif
+        // The branch back from the end might not be exact.
+        w0_exact = CELL_BITS == 32;
         break;
     case bf_opcode_end: {
-        bf_log("      tst     w0, #0xFF\n");
-        out[(*pos)++] = 0x72001c1f;
         bf_opcode *start = &opcode[opcode->amount];
-        int32_t offset_to = start->amount - (*pos);
+        uint32_t *start_branch = &out[start->amount - 1];
+        bool start_exact = (*start_branch & 0xff000000) == 0x34000000;
+        if (w0_exact) {
+            bf_log("      cbnz    w0, <tbd>\n");
+        } else {
+            bf_log("      " CELL_TEST_ASM "\n");
+            out[(*pos)++] = CELL_TEST;
+            bf_log("      b.ne    <tbd>\n");
+        }
+        int32_t offset_to = start->amount + start->offset - (*pos);
         int32_t offset_from = 2 + (*pos) - (start->amount);
-        // b.eq
-        out[start->amount - 1] = 0x54000000 | ((offset_from & ((1<<19)-1)) << 5);
-        bf_log("      b.ne    <tbd>\n");
-        out[(*pos)++] = 0x54000001 | ((offset_to & ((1<<19)-1)) << 5);
-
+        *start_branch |= (offset_from & ((1<<19)-1)) << 5;
+        out[(*pos)++] = (w0_exact ? 0x35000000 : 0x54000001) | ((offset_to & ((1<<19)-1)) << 5);
+        // w0 is zero after the loop, but only exactly zero if both branches said so.
+        w0_exact = w0_exact && start_exact;
         break;
     }
     case bf_opcode_clear:
+        if (opcode->offset != 0) {
+            access_cell(true, 31, opcode->offset, out, pos);
+            break;
+        }
         bf_log("      mov     w0, #0\n");
         out[(*pos)++] = 0x52800000;
+        w0_exact = true;
+        break;
+    case bf_opcode_scan: {
+        // Step until we load a zero
+        bf_log("      str" CELL_SUFFIX "    w0, [x19]\n");
+        out[(*pos)++] = CELL_STR | (19 << 5);
+        // Either way out, w0 is as exact as it is now.
+        if (w0_exact) {
+            bf_log("      cbz     w0, .Ldone\n");
+            out[*pos] = 0x34000000;
+        } else {
+            bf_log("      " CELL_TEST_ASM "\n");
+            out[(*pos)++] = CELL_TEST;
+            bf_log("      b.eq    .Ldone\n");
+            out[*pos] = 0x54000000;
+        }
+        size_t done_jump = (*pos)++;
+        size_t loop = *pos;
+        write_move(opcode->amount, out, pos);
+        bf_log("      cbnz    w0, .Lloop\n");
+        out[*pos] = 0x35000000 | (((int32_t)(loop - *pos) & ((1<<19)-1)) << 5);
+        ++*pos;
+        out[done_jump] |= ((*pos - done_jump) & ((1<<19)-1)) << 5;
+        break;
+    }
+    case bf_opcode_check:
+        write_check(opcode->amount, opcode->offset, out, pos);
         break;
     case bf_opcode_copy_mul: {
         // If we are multiplying by zero we ignore it.
-        if ((opcode->amount & 0xFF) == 0 || (opcode->amount >> 8) == 0) // nop
+        if (copy_mul_factor(opcode->amount) == 0 || copy_mul_target(opcode->amount) == 0) // nop
             break;
-        // sign extend
-        int32_t amount = (int8_t)opcode->amount;
+        int32_t amount = copy_mul_factor(opcode->amount);
+        int32_t target = opcode->offset + copy_mul_target(opcode->amount);
+        // The source cell is w0 if it is the current cell, otherwise we load it into w4.
+        uint32_t source = 0;
 
         // If we have a power of 2, we do this:
-        //    ldrb    x1, [x19, #offset]
-        //    add     x1, x1, w0, lsl #shift
-        //    strb    x1, [x19, #offset]
+        //    ldurb   w1, [x19, #offset]
+        //    add     w1, w1, w0, lsl #shift
+        //    sturb   w1, [x19, #offset]
         //
         // Otherwise we do this:
-        //    ldrb    x1, [x19, #offset]
-        //    mov     r2, #amt
-        //    mla     x1, w0, r2, x1
-        //    strb    x1, [x19, #offset]
-
-        // strb doesn't allow negative offsets without !, yet str does?
-        if (opcode->amount >> 8 < 0) {
-            bf_log("      sub     x3, x19, #%i\n", (-opcode->amount) >> 8);
-            out[(*pos)++] = 0xd1000263 | ((-(opcode->amount >> 8) & 0xfff) << 10);
-            bf_log("      ldrb    w1, [x3]\n");
-            out[(*pos)++] = 0x39400061;
+        //    ldurb   w1, [x19, #offset]
+        //    mov     w2, #amt
+        //    madd    w1, w0, w2, w1
+        //    sturb   w1, [x19, #offset]
+        if (opcode->offset != 0) {
+            source = 4;
+            access_cell(false, source, opcode->offset, out, pos);
+        }
+        if (target == 0) {
+            bf_log("      mov     w1, w0\n");
+            out[(*pos)++] = 0x2a0003e1;
         } else {
-            bf_log("      ldrb    w1, [x19, #%i]\n", opcode->amount >> 8);
-            // holy shift!
-            out[(*pos)++] = 0x39400261 | (((opcode->amount >> 8) & ((1 << 9) - 1)) << 10);
+            access_cell(false, 1, target, out, pos);
         }
 
         // either 0 or the opcode we need
-        uint32_t shift_insn = get_shift_add_insn(amount);
+        uint32_t shift_insn = get_shift_add_insn(amount, source);
 
         if (shift_insn == 0) { // not a power of 2, do it out
             bf_log("      mov     w2, #%i\n", amount);
@@ -256,20 +628,20 @@ static void compile_opcode(bf_opcode *restrict opcode, uint32_t *restrict out, s
             } else {
                 out[(*pos)++] = 0x52800002 | ((amount & 0xFFFF) << 5);
             }
-            // x1 = w0 * w2 + x1;
-            bf_log("      madd    w1, w0, w2, w1\n");
-            out[(*pos)++] = 0x1b020401;
+            // w1 = source * w2 + w1;
+            bf_log("      madd    w1, w%u, w2, w1\n", source);
+            out[(*pos)++] = 0x1b020401 | (source << 5);
         } else {
             // shift_insn logs
             out[(*pos)++] = shift_insn;
         }
 
-        if (opcode->amount >> 8 < 0) {
-            bf_log("      strb    w1, [x3]\n");
-            out[(*pos)++] = 0x39000061;
+        if (target == 0) {
+            bf_log("      mov     w0, w1\n");
+            out[(*pos)++] = 0x2a0103e0;
+            w0_exact = CELL_BITS == 32;
         } else {
-            bf_log("      strb    w1, [x19, #%i]\n", opcode->amount >> 8);
-            out[(*pos)++] = 0x39000261 | (((opcode->amount >> 8) & ((1 << 9) - 1)) << 10);
+            access_cell(true, 1, target, out, pos);
         }
         break;
     }
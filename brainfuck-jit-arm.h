@@ -20,31 +20,124 @@
 #   error "This is for ARMv5+ only! (try changing -march)"
 #endif
 
-// strb + blx/subs/adds + ldrb = 12 bytes
-#define MAX_INSN_LEN 16
-// size of init[]
-#define INIT_LEN 20
-// size of cleanup[]
-#define CLEANUP_LEN 4
+// copy_mul with all three cells out of range and a wide factor = 92 bytes
+#define MAX_INSN_LEN 92
+// size of init[], including the stubs
+#define INIT_LEN 88
+// Where the flush and refill stubs start in init[], in instructions
+#define FLUSH_STUB_POS 6
+#define REFILL_STUB_POS 13
+// size of cleanup[] and the flush call
+#define CLEANUP_LEN 20
 // cmp+beq, 8 bytes
 #define JUMP_INSN_LEN 8
 
 typedef uint32_t raw_opcode;
 
+// Which calling convention the generated code follows. Part of the code cache key.
+#define JIT_ABI "arm-aapcs"
+
+// strb + tst + beq + 7 for a far move + cmp + bne = 48 bytes
+#define MAX_SCAN_LEN 48
+// Two 8 instruction compares and the call, see write_check()
+#define MAX_CHECK_LEN 80
+// -DPROFILE: Two constants and 8 instructions, see write_profile_count()
+#define MAX_PROFILE_LEN 64
+
+// How far ldrb/ldrh/ldr can reach, and how we check the current cell for zero.
+#if CELL_BITS == 8
+#   define CELL_SUFFIX "b"
+#   define CELL_MAX_DISP 4095
+// ldrb r0, [r4] and strb r0, [r4]
+#   define CELL_LOAD_R0 0xe5d40000
+#   define CELL_STORE_R0 0xe5c40000
+// tst r0, #0xFF
+#   define CELL_TEST 0xe31000ff
+#   define CELL_TEST_ASM "tst     r0, #0xFF"
+#elif CELL_BITS == 16
+#   define CELL_SUFFIX "h"
+#   define CELL_MAX_DISP 255
+// ldrh r0, [r4] and strh r0, [r4]
+#   define CELL_LOAD_R0 0xe1d400b0
+#   define CELL_STORE_R0 0xe1c400b0
+// movs r12, r0, lsl #16
+#   define CELL_TEST 0xe1b0c800
+#   define CELL_TEST_ASM "movs    r12, r0, lsl #16"
+#else
+#   define CELL_SUFFIX ""
+#   define CELL_MAX_DISP 4095
+// ldr r0, [r4] and str r0, [r4]
+#   define CELL_LOAD_R0 0xe5940000
+#   define CELL_STORE_R0 0xe5840000
+// cmp r0, #0
+#   define CELL_TEST 0xe3500000
+#   define CELL_TEST_ASM "cmp     r0, #0"
+#endif
+
+// We don't use any optional instructions.
+static uint32_t jit_cpu_features(void)
+{
+    return 0;
+}
+
 // Writes the initialization code for our JIT.
+//
+// r4 is the cell pointer, r5 is the bf_io struct, r6 and r7 are io->out and io->out_end,
+// and r8 and r9 are io->in and io->in_end. After the prologue we jump over the flush and
+// refill stubs, tiny functions that sync the registers with io around a call to
+// io->flush or io->refill.
 static void write_init_code(uint32_t *restrict out, size_t *restrict pos)
 {
     const uint32_t init[] = {
-        // push { r4, r5, r6, lr }
-        0xe92d4070,
+        // push { r4, r5, r6, r7, r8, r9, r10, lr }
+        0xe92d47f0,
         // mov r4, r0 // r4 = cells
         0xe1a04000,
-        // mov r5, r1 // r5 = getchar
+        // mov r5, r1 // r5 = io
         0xe1a05001,
-        // mov r6, r2 // r6 = putchar
-        0xe1a06002,
-        // ldrb r0, [r4]
-        0xe5d40000,
+        // ldm r5, { r6, r7, r8, r9 } // r6 = io->out, r7 = io->out_end, r8 = io->in, r9 = io->in_end
+        0xe89503c0,
+        // ldr r0, [r4] // r0 = the current cell
+        CELL_LOAD_R0,
+        // b .Lstart
+        0xea00000f,
+
+        // .Lflush:
+        // push { r0, lr }
+        0xe92d4001,
+        // str r6, [r5]
+        0xe5856000,
+        // mov r0, r5
+        0xe1a00005,
+        // ldr r12, [r5, #16] // io->flush
+        0xe595c010,
+        // blx r12
+        0xe12fff3c,
+        // ldr r6, [r5]
+        0xe5956000,
+        // pop { r0, pc }
+        0xe8bd8001,
+
+        // .Lrefill:
+        // push { r0, lr }
+        0xe92d4001,
+        // str r6, [r5]
+        0xe5856000,
+        // mov r0, r5
+        0xe1a00005,
+        // ldr r12, [r5, #20] // io->refill
+        0xe595c014,
+        // blx r12
+        0xe12fff3c,
+        // ldr r6, [r5]
+        0xe5956000,
+        // ldr r8, [r5, #8]
+        0xe5958008,
+        // ldr r9, [r5, #12]
+        0xe595900c,
+        // pop { r0, pc }
+        0xe8bd8001,
+        // .Lstart:
     };
     memcpy(out + (*pos), init, sizeof(init));
     *pos += sizeof(init) / sizeof(uint32_t);
@@ -54,120 +147,349 @@ static void write_init_code(uint32_t *restrict out, size_t *restrict pos)
         "      .globl fuck\n"
         "      .type fuck,%%function\n"
         "fuck:\n"
-        "      push    { r4, r5, r6, lr }\n"
+        "      push    { r4, r5, r6, r7, r8, r9, r10, lr }\n"
         "      mov     r4, r0 @ r4 = cells\n"
-        "      mov     r5, r1 @ r5 = &getchar\n"
-        "      mov     r6, r2 @ r6 = &putchar\n"
-        "      mov     r0, #0 @ start with an initial zero\n"
+        "      mov     r5, r1 @ r5 = io\n"
+        "      ldm     r5, { r6, r7, r8, r9 } @ r6 = io->out, r7 = io->out_end, r8 = io->in, r9 = io->in_end\n"
+        "      ldr" CELL_SUFFIX "    r0, [r4]\n"
+        "      b       .Lstart\n"
+        ".Lflush:\n"
+        "      push    { r0, lr }\n"
+        "      str     r6, [r5]\n"
+        "      mov     r0, r5\n"
+        "      ldr     r12, [r5, #16] @ io->flush\n"
+        "      blx     r12\n"
+        "      ldr     r6, [r5]\n"
+        "      pop     { r0, pc }\n"
+        ".Lrefill:\n"
+        "      push    { r0, lr }\n"
+        "      str     r6, [r5]\n"
+        "      mov     r0, r5\n"
+        "      ldr     r12, [r5, #20] @ io->refill\n"
+        "      blx     r12\n"
+        "      ldr     r6, [r5]\n"
+        "      ldr     r8, [r5, #8]\n"
+        "      ldr     r9, [r5, #12]\n"
+        "      pop     { r0, pc }\n"
+        ".Lstart:\n"
     );
 }
 
+// Writes a call to one of the stubs in init[], with a condition.
+static void write_stub_call(uint32_t cond, size_t stub, uint32_t *restrict out, size_t *restrict pos)
+{
+    bf_log("      bl%s    %s\n", cond == 0xe ? "  " : cond == 0x2 ? "hs" : "lo",
+           stub == FLUSH_STUB_POS ? ".Lflush" : ".Lrefill");
+    out[*pos] = (cond << 28) | 0x0b000000 | ((uint32_t)((int32_t)stub - (int32_t)(*pos + 2)) & 0xFFFFFF);
+    ++*pos;
+}
+
 // Writes the cleanup code for our JIT.
 static void write_cleanup_code(uint32_t *restrict out, size_t *restrict pos)
 {
+    // Anything left in the buffer goes out before we return.
+    write_stub_call(0xe, FLUSH_STUB_POS, out, pos);
+    // Hands back io->in and the current cell, and returns the cell pointer.
     const uint32_t cleanup[] = {
-        // pop { r4, r5, r6, pc }
-        0xe8bd8070,
+        // str r8, [r5, #8]
+        0xe5858008,
+        // str r0, [r4]
+        CELL_STORE_R0,
+        // mov r0, r4
+        0xe1a00004,
+        // pop { r4, r5, r6, r7, r8, r9, r10, pc }
+        0xe8bd87f0,
     };
     memcpy(out + (*pos), cleanup, sizeof(cleanup));
     *pos += sizeof(cleanup) / sizeof(uint32_t);
-    bf_log("      pop     { r4, r5, r6, pc }\n");
+    bf_log(
+        "      str     r8, [r5, #8]\n"
+        "      str" CELL_SUFFIX "    r0, [r4]\n"
+        "      mov     r0, r4\n"
+        "      pop     { r4, r5, r6, r7, r8, r9, r10, pc }\n"
+    );
 }
 
-// Returns the opcode for add r1, r1, r0, lsl #log2(val&0xff) if val & 0xff
-// is a power of 2, or zero if it isn't.
+// Returns the opcode for add r1, r1, rSource, lsl #log2(val) if val is a power of 2, or
+// zero if it isn't.
 //
 // add r1, r1, r0, lsl #2
 // r1 = r1 + (r0 << 2);
-static inline uint32_t get_shift_add_insn(int32_t val)
+static inline uint32_t get_shift_add_insn(uint32_t val, uint32_t source)
 {
-    switch (val & 0xFF) {
+    switch (val) {
         case 1 << 0: // 1 - normal add insn
-            bf_log("      add     r1, r1, r0\n");
-            return 0xe0811000;
+            bf_log("      add     r1, r1, r%u\n", source);
+            return 0xe0811000 | source;
         case 1 << 1: // 2
-            bf_log("      add     r1, r1, r0, lsl #1\n");
-            return 0xe0811080;
+            bf_log("      add     r1, r1, r%u, lsl #1\n", source);
+            return 0xe0811080 | source;
         case 1 << 2: // 4
-            bf_log("      add     r1, r1, r0, lsl #2\n");
-            return 0xe0811100;
+            bf_log("      add     r1, r1, r%u, lsl #2\n", source);
+            return 0xe0811100 | source;
         case 1 << 3: // 8
-            bf_log("      add     r1, r1, r0, lsl #3\n");
-            return 0xe0811180;
+            bf_log("      add     r1, r1, r%u, lsl #3\n", source);
+            return 0xe0811180 | source;
         case 1 << 4: // 16
-            bf_log("      add     r1, r1, r0, lsl #4\n");
-            return 0xe0811200;
+            bf_log("      add     r1, r1, r%u, lsl #4\n", source);
+            return 0xe0811200 | source;
         case 1 << 5: // 32
-            bf_log("      add     r1, r1, r0, lsl #5\n");
-            return 0xe0811280;
+            bf_log("      add     r1, r1, r%u, lsl #5\n", source);
+            return 0xe0811280 | source;
         case 1 << 6: // 64
-            bf_log("      add     r1, r1, r0, lsl #6\n");
-            return 0xe0811300;
+            bf_log("      add     r1, r1, r%u, lsl #6\n", source);
+            return 0xe0811300 | source;
         case 1 << 7: // 128
-            bf_log("      add     r1, r1, r0, lsl #7\n");
-            return 0xe0811380;
+            bf_log("      add     r1, r1, r%u, lsl #7\n", source);
+            return 0xe0811380 | source;
         default:
             return 0;
     }
 }
 
+// Returns ldr/str rN, [rBase, #bytes] for a cell, with writeback if it is set. bytes
+// must be within CELL_MAX_DISP.
+static uint32_t cell_insn(bool store, bool writeback, uint32_t reg, uint32_t base, int32_t bytes)
+{
+    uint32_t up = bytes >= 0 ? 1u << 23 : 0;
+    uint32_t disp = (uint32_t)(bytes >= 0 ? bytes : -bytes);
+    uint32_t insn = (writeback ? 1u << 21 : 0) | up | (base << 16) | (reg << 12);
+#if CELL_BITS == 16
+    // ldrh/strh split the offset in two nibbles.
+    return insn | (store ? 0xe14000b0 : 0xe15000b0) | ((disp & 0xF0) << 4) | (disp & 0xF);
+#else
+    // ldrb/strb are ldr/str with the B bit.
+    return insn | (store ? 0xe5000000 : 0xe5100000) | (CELL_BITS == 8 ? 1u << 22 : 0) | disp;
+#endif
+}
+
+// Builds value in rN. ARMv5 has no movw, so it is done a byte at a time.
+static void write_constant(uint32_t reg, uint32_t value, uint32_t *restrict out, size_t *restrict pos)
+{
+    bf_log("      mov     r%u, #%u\n", reg, value & 0xFF);
+    out[(*pos)++] = 0xe3a00000 | (reg << 12) | (value & 0xFF);
+    for (uint32_t shift = 8; shift < 32; shift += 8) {
+        if ((value >> shift) & 0xFF) {
+            bf_log("      orr     r%u, r%u, #%u\n", reg, reg, value & (0xFFu << shift));
+            // The immediate is rotated right by twice the rotate field.
+            out[(*pos)++] = 0xe3800000 | (reg << 16) | (reg << 12) | (((32 - shift) / 2) << 8) | ((value >> shift) & 0xFF);
+        }
+    }
+}
+
+// Puts the address of the cell at r4 + offset in r12. Big offsets are built in r2.
+static void write_cell_address(int32_t offset, uint32_t *restrict out, size_t *restrict pos)
+{
+    offset *= CELL_BYTES;
+    if (offset >= 0 && offset <= 255) {
+        bf_log("      add     r12, r4, #%i\n", offset);
+        out[(*pos)++] = 0xe284c000 | (uint32_t)offset;
+        return;
+    }
+    if (offset < 0 && offset >= -255) {
+        bf_log("      sub     r12, r4, #%i\n", -offset);
+        out[(*pos)++] = 0xe244c000 | (uint32_t)-offset;
+        return;
+    }
+    write_constant(2, (uint32_t)offset, out, pos);
+    bf_log("      add     r12, r4, r2\n");
+    out[(*pos)++] = 0xe084c002;
+}
+
+// Loads or stores rN from the cell at r4 + offset. The current cell lives in r0, so
+// this is only for the others. Offsets out of range go through r12.
+static void access_cell(bool store, uint32_t reg, int32_t offset, uint32_t *restrict out, size_t *restrict pos)
+{
+    int32_t bytes = offset * CELL_BYTES;
+    if (bytes >= -CELL_MAX_DISP && bytes <= CELL_MAX_DISP) {
+        bf_log("      %s" CELL_SUFFIX "    r%u, [r4, #%i]\n", store ? "str" : "ldr", reg, bytes);
+        out[(*pos)++] = cell_insn(store, false, reg, 4, bytes);
+        return;
+    }
+    write_cell_address(offset, out, pos);
+    bf_log("      %s" CELL_SUFFIX "    r%u, [r12]\n", store ? "str" : "ldr", reg);
+    out[(*pos)++] = cell_insn(store, false, reg, 12, 0);
+}
+
+// Moves r4 by amount cells and loads the new cell into r0.
+static void write_move(int32_t amount, uint32_t *restrict out, size_t *restrict pos)
+{
+    int32_t bytes = amount * CELL_BYTES;
+    if (bytes >= -CELL_MAX_DISP && bytes <= CELL_MAX_DISP) {
+        bf_log("      ldr" CELL_SUFFIX "    r0, [r4, #%i]!\n", bytes);
+        out[(*pos)++] = cell_insn(false, true, 0, 4, bytes);
+        return;
+    }
+    write_cell_address(amount, out, pos);
+    bf_log("      mov     r4, r12\n");
+    out[(*pos)++] = 0xe1a0400c;
+    bf_log("      ldr" CELL_SUFFIX "    r0, [r4]\n");
+    out[(*pos)++] = cell_insn(false, false, 0, 4, 0);
+}
+
+// Adds amount to rN, using r2 if it doesn't fit in an immediate.
+static void write_add(uint32_t reg, int32_t amount, uint32_t *restrict out, size_t *restrict pos)
+{
+    // Only the bits that fit in a cell matter.
+    uint32_t value = (uint32_t)(amount > 0 ? amount : -amount) & CELL_MASK;
+    if (value == 0) {
+        return;
+    }
+    if (value <= 255) {
+        bf_log("      %s     r%u, r%u, #%u\n", amount > 0 ? "add" : "sub", reg, reg, value);
+        out[(*pos)++] = (amount > 0 ? 0xe2800000 : 0xe2400000) | (reg << 16) | (reg << 12) | value;
+        return;
+    }
+    write_constant(2, value, out, pos);
+    bf_log("      %s     r%u, r%u, r2\n", amount > 0 ? "add" : "sub", reg, reg);
+    out[(*pos)++] = (amount > 0 ? 0xe0800002 : 0xe0400002) | (reg << 16) | (reg << 12);
+}
+
+// Checked builds: Calls io->tape_error unless cells lo to hi are within io->tape_start
+// and io->tape_end. The output pointer is synced first so it can flush.
+static void write_check(int32_t lo, int32_t hi, uint32_t *restrict out, size_t *restrict pos)
+{
+    write_cell_address(lo, out, pos);
+    bf_log("      ldr     r2, [r5, #32] @ io->tape_start\n");
+    out[(*pos)++] = 0xe5952020;
+    bf_log("      cmp     r12, r2\n");
+    out[(*pos)++] = 0xe15c0002;
+    bf_log("      blo     1f\n");
+    size_t low_jump = (*pos)++;
+    write_cell_address(hi, out, pos);
+    bf_log("      ldr     r2, [r5, #36] @ io->tape_end\n");
+    out[(*pos)++] = 0xe5952024;
+    bf_log("      cmp     r12, r2\n");
+    out[(*pos)++] = 0xe15c0002;
+    bf_log("      blo     2f\n");
+    out[(*pos)++] = 0x3a000003;
+    out[low_jump] = 0x3a000000 | ((*pos - (low_jump + 2)) & 0xFFFFFF);
+    bf_log("1:\n");
+    bf_log("      str     r6, [r5]\n");
+    out[(*pos)++] = 0xe5856000;
+    bf_log("      mov     r0, r5\n");
+    out[(*pos)++] = 0xe1a00005;
+    bf_log("      ldr     r12, [r5, #40] @ io->tape_error\n");
+    out[(*pos)++] = 0xe595c028;
+    bf_log("      blx     r12\n");
+    out[(*pos)++] = 0xe12fff3c;
+    bf_log("2:\n");
+}
+
+#ifdef PROFILE
+// -DPROFILE: Adds one to the 64-bit io->profile_counts[site], with r1, r2 and r12.
+static void write_profile_count(uint32_t site, uint32_t *restrict out, size_t *restrict pos)
+{
+    write_constant(2, (uint32_t)offsetof(bf_io, profile_counts), out, pos);
+    bf_log("      ldr     r12, [r5, r2] @ io->profile_counts\n");
+    out[(*pos)++] = 0xe795c002;
+    write_constant(2, site * (uint32_t)sizeof(uint64_t), out, pos);
+    bf_log("      add     r12, r12, r2\n");
+    out[(*pos)++] = 0xe08cc002;
+    bf_log("      ldr     r1, [r12]\n");
+    out[(*pos)++] = 0xe59c1000;
+    bf_log("      adds    r1, r1, #1\n");
+    out[(*pos)++] = 0xe2911001;
+    bf_log("      str     r1, [r12]\n");
+    out[(*pos)++] = 0xe58c1000;
+    bf_log("      ldr     r1, [r12, #4]\n");
+    out[(*pos)++] = 0xe59c1004;
+    bf_log("      adc     r1, r1, #0\n");
+    out[(*pos)++] = 0xe2a11000;
+    bf_log("      str     r1, [r12, #4]\n");
+    out[(*pos)++] = 0xe58c1004;
+}
+#endif
+
 static void compile_opcode(bf_opcode *restrict opcode, uint32_t *restrict out, size_t *restrict pos)
 {
+#ifdef PROFILE
+    // Loops count at the top of their body, the ones we turned into something else
+    // count here.
+    if (opcode->site != 0 && opcode->op != bf_opcode_start) {
+        write_profile_count(opcode->site - 1, out, pos);
+    }
+#endif
     if (opcode->op == bf_opcode_nop)
         return;
     switch (opcode->op) {
     case bf_opcode_add:
-        if (opcode->amount > 0) {
-            bf_log("      add     r0, r0, #%i\n", opcode->amount & 0xff);
-            out[(*pos)++] = 0xe2800000 | (opcode->amount & 0xff);
-        } else if (opcode->amount < 0) {
-            bf_log("      sub     r0, r0, #%i\n", (-opcode->amount) & 0xff);
-            out[(*pos)++] = 0xe2400000 | ((-opcode->amount) & 0xff);
+        if (opcode->offset != 0) {
+            // Not the current cell, so we do it in memory
+            access_cell(false, 1, opcode->offset, out, pos);
+            write_add(1, opcode->amount, out, pos);
+            access_cell(true, 1, opcode->offset, out, pos);
+        } else {
+            write_add(0, opcode->amount, out, pos);
         }
         break;
     case bf_opcode_move:
         if (opcode->amount == 0)
             break;
-        bf_log("      strb    r0, [r4]\n");
+        bf_log("      str" CELL_SUFFIX "    r0, [r4]\n");
         // Save our working copy
-        out[(*pos)++] = 0xe5c40000;
-        bf_log("      ldrb    r0, [r4, #%i]!\n", opcode->amount);
-        if (opcode->amount > 0) {
-
-            out[(*pos)++] = 0xe5f40000 | (opcode->amount & ((1 << 12) - 1));
-        } else {
-            out[(*pos)++] = 0xe5740000 | ((-opcode->amount) & ((1 << 12) - 1));
-        }
+        out[(*pos)++] = cell_insn(true, false, 0, 4, 0);
+        write_move(opcode->amount, out, pos);
         break;
-    case bf_opcode_put:
-        bf_log("      strb    r0, [r4]\n");
-        out[(*pos)++] = 0xe5c40000;
-
-        bf_log("      blx     r5\n");
-        out[(*pos)++] = 0xe12fff35;
-
-        bf_log("      ldrb    r0, [r4]\n");
-        out[(*pos)++] = 0xe5d40000;
+    case bf_opcode_put: {
+        // Append the cell to the buffer, and flush it when it fills up.
+        uint32_t reg = 0;
+        if (opcode->offset != 0) {
+            reg = 1;
+            access_cell(false, reg, opcode->offset, out, pos);
+        }
+        bf_log("      strb    r%u, [r6], #1\n", reg);
+        out[(*pos)++] = 0xe4c60001 | (reg << 12);
+        bf_log("      cmp     r6, r7\n");
+        out[(*pos)++] = 0xe1560007;
+        // cc (lo)
+        write_stub_call(0x3, FLUSH_STUB_POS, out, pos);
         break;
-    case bf_opcode_get:
-        bf_log("      blx     r6\n");
-        out[(*pos)++] = 0xe12fff36;
+    }
+    case bf_opcode_get: {
+        // Take the next byte from the input buffer, and refill it if it is empty.
+        bf_log("      cmp     r8, r9\n");
+        out[(*pos)++] = 0xe1580009;
+        // cs (hs)
+        write_stub_call(0x2, REFILL_STUB_POS, out, pos);
+        uint32_t reg = opcode->offset != 0 ? 1 : 0;
+        bf_log("      ldrb    r%u, [r8], #1\n", reg);
+        out[(*pos)++] = 0xe4d80001 | (reg << 12);
+        if (opcode->offset != 0) {
+            access_cell(true, reg, opcode->offset, out, pos);
+        }
         break;
+    }
     case bf_opcode_start:
-        bf_log("      tst     r0, #0xFF\n");
-        out[(*pos)++] = 0xe31000ff;
+        bf_log("      " CELL_TEST_ASM "\n");
+        out[(*pos)++] = CELL_TEST;
 
         bf_log("      beq     <tbd>\n");
 
         *pos += 1; // skip beq
-        opcode->amount = (int32_t)(*pos);
+        {
+            // Line the body up with nops, see loop_padding().
+            size_t pad = loop_padding(opcode, *pos * sizeof(uint32_t)) / sizeof(uint32_t);
+            opcode->amount = (int32_t)(*pos);
+            opcode->offset = (int32_t)pad;
+            for (size_t i = 0; i < pad; i++) {
+                // ARMv5 has no nop instruction.
+                bf_log("      mov     r0, r0\n");
+                out[(*pos)++] = 0xe1a00000;
+            }
+        }
+#ifdef PROFILE
+        if (opcode->site != 0) {
+            write_profile_count(opcode->site - 1, out, pos);
+        }
+#endif
         break;
     case bf_opcode_end: {
 
-        bf_log("      tst     r0, #0xFF\n");
-        out[(*pos)++] = 0xe31000ff;
+        bf_log("      " CELL_TEST_ASM "\n");
+        out[(*pos)++] = CELL_TEST;
         bf_opcode *start = &opcode[opcode->amount];
-        int32_t offset_to = start->amount - (*pos + 2);
+        int32_t offset_to = start->amount + start->offset - (*pos + 2);
         int32_t offset_from = (*pos) - (start->amount);
         out[start->amount - 1] = 0x0a000000 | (offset_from & 0xFFFFFF);
         bf_log("      bne     <tbd>\n");
@@ -176,13 +498,46 @@ static void compile_opcode(bf_opcode *restrict opcode, uint32_t *restrict out, s
         break;
     }
     case bf_opcode_clear:
+        if (opcode->offset != 0) {
+            bf_log("      mov     r1, #0\n");
+            out[(*pos)++] = 0xe3a01000;
+            access_cell(true, 1, opcode->offset, out, pos);
+            break;
+        }
         bf_log("      mov     r0, #0\n");
         out[(*pos)++] = 0xe3a00000;
         break;
+    case bf_opcode_scan: {
+        // Step until we load a zero
+        bf_log("      str" CELL_SUFFIX "    r0, [r4]\n");
+        out[(*pos)++] = cell_insn(true, false, 0, 4, 0);
+        bf_log("      " CELL_TEST_ASM "\n");
+        out[(*pos)++] = CELL_TEST;
+        bf_log("      beq     .Ldone\n");
+        size_t done_jump = (*pos)++;
+        size_t loop = *pos;
+        write_move(opcode->amount, out, pos);
+        bf_log("      cmp     r0, #0\n");
+        out[(*pos)++] = 0xe3500000;
+        bf_log("      bne     .Lloop\n");
+        out[*pos] = 0x1a000000 | ((int32_t)(loop - (*pos + 2)) & 0xFFFFFF);
+        ++*pos;
+        out[done_jump] = 0x0a000000 | ((*pos - (done_jump + 2)) & 0xFFFFFF);
+        break;
+    }
+    case bf_opcode_check:
+        write_check(opcode->amount, opcode->offset, out, pos);
+        break;
     case bf_opcode_copy_mul: {
         // If we are multiplying by zero we ignore it.
-        if ((opcode->amount & 0xFF) == 0 || (opcode->amount >> 8) == 0) // nop
+        if (copy_mul_factor(opcode->amount) == 0 || copy_mul_target(opcode->amount) == 0) // nop
             break;
+        // Wrapped to the cell width, so negative factors are plain multiplies.
+        uint32_t factor = (uint32_t)copy_mul_factor(opcode->amount) & CELL_MASK;
+        int32_t target = opcode->offset + copy_mul_target(opcode->amount);
+        // The source cell is r0 if it is the current cell, otherwise we load it into r3.
+        uint32_t source = 0;
+
         // If we have a power of 2, we do this:
         //    ldrb    r1, [r4, #offset]
         //    add     r1, r1, r0, lsl #shift
@@ -193,27 +548,37 @@ static void compile_opcode(bf_opcode *restrict opcode, uint32_t *restrict out, s
         //    mov     r2, #amt
         //    mla     r1, r0, r2, r1
         //    strb    r1, [r4, #offset]
-
-        bf_log("      ldrb    r1, [r4, #%i]\n", opcode->amount >> 8);
-        out[(*pos)++] = 0xe5d41000 | ((opcode->amount >> 8) & 4095);
+        if (opcode->offset != 0) {
+            source = 3;
+            access_cell(false, source, opcode->offset, out, pos);
+        }
+        if (target == 0) {
+            bf_log("      mov     r1, r0\n");
+            out[(*pos)++] = 0xe1a01000;
+        } else {
+            access_cell(false, 1, target, out, pos);
+        }
 
         // either 0 or the opcode we need
-        uint32_t shift_insn = get_shift_add_insn(opcode->amount);
+        uint32_t shift_insn = get_shift_add_insn(factor, source);
 
         if (shift_insn == 0) { // not power of 2
-            bf_log("      mov     r2, #%i\n", opcode->amount & 0xff);
-            out[(*pos)++] = 0xe3a02000 | (opcode->amount & 0xFF);
+            write_constant(2, factor, out, pos);
 
-            // r1 = r0 * r2 + r1;
-            bf_log("      mla     r1, r0, r2, r1\n");
-            out[(*pos)++] = 0xe0211290;
+            // r1 = source * r2 + r1;
+            bf_log("      mla     r1, r%u, r2, r1\n", source);
+            out[(*pos)++] = 0xe0211290 | source;
         } else {
             // shift_insn logs
             out[(*pos)++] = shift_insn;
         }
 
-        bf_log("      strb    r1, [r4, #%i]\n", opcode->amount >> 8);
-        out[(*pos)++] = 0xe5c41000 | ((opcode->amount >> 8) & 4095);
+        if (target == 0) {
+            bf_log("      mov     r0, r1\n");
+            out[(*pos)++] = 0xe1a00001;
+        } else {
+            access_cell(true, 1, target, out, pos);
+        }
         break;
     }
     default:
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2019 easyaspi314
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ */
+
+/// On-disk cache for JIT output.
+///
+/// The generated code is position independent: jumps are relative, and I/O goes through
+/// the function pointers we pass in. That means we can write it to a file and mmap it
+/// straight back in as R^X, skipping the parser and the code generator entirely.
+///
+/// Each entry is the raw code, then the source, then a bf_cache_trailer, in a file named
+/// after the key. The key is only a 64-bit FNV-1a hash, which is easy to collide, so we
+/// compare the source and the build parameters before running anything from the cache.
+#ifndef BRAINFUCK_JIT_CACHE_UNIX_H
+#define BRAINFUCK_JIT_CACHE_UNIX_H
+#if !defined(__unix__) && !defined(__APPLE__)
+#   error "This code is for Unix."
+#endif
+
+#ifndef BRAINFUCK_JIT_C
+#   error "This file is only to be included from brainfuck-jit.c"
+#endif
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#define HAVE_CODE_CACHE 1
+
+// Bump this whenever the generated code changes.
+#define CACHE_VERSION 15
+
+// Everything besides the source that affects the generated code.
+typedef struct {
+    char abi[32];
+    int32_t params[8];
+} bf_cache_params;
+
+typedef struct {
+    char magic[8];
+    uint64_t key;
+    bf_cache_params params;
+    uint64_t source_len;
+    uint64_t code_size;
+    // What analyze_tape() found, since we don't keep the IR.
+    int32_t tape_bounded;
+    int32_t tape_min;
+    int32_t tape_max;
+    int32_t tape_stride;
+} bf_cache_trailer;
+
+static const char cache_magic[8] = { 'B', 'F', 'J', 'I', 'T', 'C', 'C', '\0' };
+
+// FNV-1a, 64-bit.
+static uint64_t cache_hash(uint64_t hash, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static void cache_params(bf_cache_params *out, int optlevel)
+{
+    const int32_t params[] = {
+        CACHE_VERSION, JIT_MODE, BF_CHECKED, CELL_BITS, LOOP_ALIGN, LOOP_ALIGN_MAX_SKIP, optlevel, (int32_t)jit_cpu_features()
+    };
+    // Zeroed, so it hashes and compares the same every time.
+    memset(out, 0, sizeof(*out));
+    strncpy(out->abi, JIT_ABI, sizeof(out->abi) - 1);
+    memcpy(out->params, params, sizeof(params));
+}
+
+// Hashes everything that affects the generated code.
+static uint64_t cache_key(const char *code, size_t len, int optlevel)
+{
+    bf_cache_params params;
+    cache_params(&params, optlevel);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash = cache_hash(hash, &params, sizeof(params));
+    return cache_hash(hash, code, len);
+}
+
+static void cache_path(char *out, size_t out_len, const char *dir, uint64_t key)
+{
+    snprintf(out, out_len, "%s/%016llx.bfc", dir, (unsigned long long)key);
+}
+
+// Maps a cached entry as R^X. Returns false on a miss, or if the entry is for something
+// else with the same key.
+static bool load_cached_code(brainfuck_program *restrict program, const char *restrict dir, uint64_t key, const char *restrict code, size_t len)
+{
+    char path[4096];
+    cache_path(path, sizeof(path), dir, key);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    bf_cache_trailer trailer;
+    bf_cache_params params;
+    cache_params(&params, program->optlevel);
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(trailer)
+     || pread(fd, &trailer, sizeof(trailer), st.st_size - sizeof(trailer)) != (ssize_t)sizeof(trailer)
+     || memcmp(trailer.magic, cache_magic, sizeof(cache_magic)) != 0
+     || trailer.key != key
+     || memcmp(&trailer.params, &params, sizeof(params)) != 0
+     || trailer.source_len != len
+     || trailer.code_size != (uint64_t)st.st_size - sizeof(trailer) - len) {
+        bf_log("cache: bad entry %s\n", path);
+        close(fd);
+        return false;
+    }
+    // Map it read-only until we know it's ours.
+    void *buf = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (buf == MAP_FAILED) {
+        return false;
+    }
+    if (memcmp((const char *)buf + trailer.code_size, code, len) != 0) {
+        bf_log("cache: collision %s\n", path);
+        munmap(buf, st.st_size);
+        return false;
+    }
+    // Fails on noexec mounts, in which case we just compile it.
+    if (mprotect(buf, st.st_size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(buf, st.st_size);
+        return false;
+    }
+    bf_log("cache: hit %s\n", path);
+    program->code = buf;
+    program->code_len = st.st_size;
+    program->code_size = trailer.code_size;
+    program->tape_bounded = trailer.tape_bounded != 0;
+    program->tape_min = trailer.tape_min;
+    program->tape_max = trailer.tape_max;
+    program->tape_stride = trailer.tape_stride;
+    return true;
+}
+
+// Writes the compiled code to the cache. This is best effort, errors are ignored.
+static void store_cached_code(const brainfuck_program *restrict program, const char *restrict dir, uint64_t key, const char *restrict code, size_t len)
+{
+    char path[4096], tmp[4096 + 16];
+    cache_path(path, sizeof(path), dir, key);
+    // Write to a temporary file and rename it so other processes and threads never see
+    // half an entry.
+    snprintf(tmp, sizeof(tmp), "%s.XXXXXX", path);
+
+    int fd = mkstemp(tmp);
+    if (fd < 0) {
+        return;
+    }
+    bf_cache_trailer trailer;
+    memcpy(trailer.magic, cache_magic, sizeof(cache_magic));
+    trailer.key = key;
+    cache_params(&trailer.params, program->optlevel);
+    trailer.source_len = len;
+    trailer.code_size = program->code_size;
+    trailer.tape_bounded = program->tape_bounded;
+    trailer.tape_min = program->tape_min;
+    trailer.tape_max = program->tape_max;
+    trailer.tape_stride = program->tape_stride;
+
+    bool ok = write(fd, program->code, program->code_size) == (ssize_t)program->code_size
+           && write(fd, code, len) == (ssize_t)len
+           && write(fd, &trailer, sizeof(trailer)) == (ssize_t)sizeof(trailer);
+    close(fd);
+    if (!ok || rename(tmp, path) < 0) {
+        unlink(tmp);
+        return;
+    }
+    bf_log("cache: stored %s\n", path);
+}
+
+#endif // BRAINFUCK_JIT_CACHE_UNIX_H
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2019 easyaspi314
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ */
+
+/// brainfuck-jit-loops.h: Compiling one loop at a time, for -DTIERED and -DLAZY.
+///
+/// A loop gets the same init and cleanup code as a whole program, so it can be called as
+/// fuck(cells, io) from the loop head, and returns the pointer where the loop left it.
+/// The compiled loops live in program->loop_code, and are shared by every run of the
+/// program, so they are published with a compare and swap.
+#ifndef BRAINFUCK_JIT_LOOPS_H
+#define BRAINFUCK_JIT_LOOPS_H
+
+#ifndef BRAINFUCK_JIT_C
+#   error "This file is only to be included from brainfuck-jit.c"
+#endif
+#include <string.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   include <intrin.h>
+#endif
+
+// Compiles the loop at start into its own buffer. Returns NULL when out of memory.
+static raw_opcode *compile_loop(const bf_opcode *start, size_t *restrict code_len)
+{
+    // The backends write their bookkeeping into the IR, so they get a copy.
+    size_t len = (size_t)start->amount + 1;
+    bf_opcode *ir = (bf_opcode *)malloc(len * sizeof(bf_opcode));
+    if (ir == NULL) {
+        return NULL;
+    }
+    memcpy(ir, start, len * sizeof(bf_opcode));
+    for (size_t i = 0; i < len; i++) {
+        if (ir[i].op == bf_opcode_start) {
+            ir[i].offset = 0;
+        }
+    }
+
+    size_t memlen = max_code_len(ir, len), pos = 0;
+    raw_opcode *code = alloc_opcodes(memlen);
+    if (code != NULL) {
+        write_init_code(code, &pos);
+        for (size_t i = 0; i < len; i++) {
+            compile_opcode(&ir[i], code, &pos);
+        }
+        write_cleanup_code(code, &pos);
+        protect_opcodes(code, memlen);
+        *code_len = memlen;
+    }
+    free(ir);
+    return code;
+}
+
+// Stores code in *slot if it still holds expected, and returns what was there before.
+static void *publish_loop(void **slot, void *expected, void *code)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _InterlockedCompareExchangePointer((void *volatile *)slot, code, expected);
+#else
+    __atomic_compare_exchange_n(slot, &expected, code, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    return expected;
+#endif
+}
+
+#endif // BRAINFUCK_JIT_LOOPS_H
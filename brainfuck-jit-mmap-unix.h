@@ -24,6 +24,9 @@
 #include <string.h>
 #include <stddef.h>
 #include <sys/mman.h>
+#include <signal.h> // sigaction
+#include <setjmp.h> // sigsetjmp
+#include <pthread.h> // pthread_once
 
 static raw_opcode *alloc_opcodes(size_t len)
 {
@@ -33,8 +36,11 @@ static raw_opcode *alloc_opcodes(size_t len)
     int prot = PROT_READ | PROT_WRITE;
 #endif
     int flags = MAP_ANONYMOUS | MAP_PRIVATE;
-    raw_opcode *buf = (raw_opcode *)mmap(NULL, len, prot, flags, -1, 0);
-    return buf;
+    void *buf = mmap(NULL, len, prot, flags, -1, 0);
+    if (buf == MAP_FAILED) {
+        return NULL;
+    }
+    return (raw_opcode *)buf;
 }
 
 static void protect_opcodes(raw_opcode *buf, size_t len)
@@ -53,5 +59,110 @@ static void dealloc_opcodes(raw_opcode *buf, size_t len)
     munmap(buf, len);
 }
 
+// The tape is one big PROT_NONE reservation. Only the first 64 KiB around cell 0 are
+// mapped up front, and the SIGSEGV handler maps another chunk whenever the program
+// touches a new one, so the hot path never checks bounds. The guard regions at either
+// end are never mapped, so running off the tape is an error instead of heap corruption.
+//
+// Growing in place matters: mremap() could move the tape out from under the pointer the
+// generated code keeps in a register.
+#if UINTPTR_MAX > 0xFFFFFFFF
+#   define TAPE_RESERVE ((size_t)1 << 30)
+#   define TAPE_GUARD ((size_t)16 << 20)
+#else
+#   define TAPE_RESERVE ((size_t)64 << 20)
+#   define TAPE_GUARD ((size_t)4 << 20)
+#endif
+// How much we map at a time. The chunk before cell 0 is mapped read-only, as padding for
+// the vectorized scans, so writing to it still runs off the tape.
+#define TAPE_CHUNK ((size_t)64 << 10)
+// Where cell 0 is.
+#define TAPE_START (TAPE_GUARD + TAPE_CHUNK)
+#define HAVE_GUARD_TAPE 1
+
+typedef struct {
+    uint8_t *base;
+    // Where the fault handler goes when the program runs off the tape, and where
+    // end_run() goes.
+    sigjmp_buf escape;
+} bf_tape;
+
+// The tape of the program running on this thread, if any. The fault is delivered to the
+// thread that caused it, so this tells the handler whose tape it is.
+static bf_thread_local bf_tape *current_tape;
+
+static pthread_once_t tape_handler_once = PTHREAD_ONCE_INIT;
+static struct sigaction old_segv_action, old_bus_action;
+
+// Maps in the chunk the program just touched. Anything below cell 0, like a write to the
+// read-only padding, is off the tape.
+static void tape_fault(int sig, siginfo_t *info, void *context)
+{
+    bf_tape *tape = current_tape;
+    uint8_t *addr = (uint8_t *)info->si_addr;
+    if (tape != NULL && addr >= tape->base && addr < tape->base + TAPE_RESERVE) {
+        size_t chunk = (size_t)(addr - tape->base) & ~(TAPE_CHUNK - 1);
+        if (chunk >= TAPE_START && chunk < TAPE_RESERVE - TAPE_GUARD
+            && mprotect(tape->base + chunk, TAPE_CHUNK, PROT_READ | PROT_WRITE) == 0) {
+            // Retry the access.
+            return;
+        }
+        siglongjmp(tape->escape, BF_RAN_OFF_TAPE);
+    }
+    // Not ours. Pass it on to whoever had the signal before us, and stay installed in
+    // case they recover from it.
+    const struct sigaction *old = sig == SIGSEGV ? &old_segv_action : &old_bus_action;
+    if (old->sa_flags & SA_SIGINFO) {
+        old->sa_sigaction(sig, info, context);
+    } else if (old->sa_handler != SIG_DFL && old->sa_handler != SIG_IGN) {
+        old->sa_handler(sig);
+    } else {
+        // Nobody handles it, so crash the way we would have without us.
+        signal(sig, SIG_DFL);
+        raise(sig);
+    }
+}
+
+static void install_tape_handler(void)
+{
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = &tape_fault;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGSEGV, &action, &old_segv_action);
+    // macOS raises SIGBUS for PROT_NONE pages.
+    sigaction(SIGBUS, &action, &old_bus_action);
+}
+
+// Runs the generated code on a fresh tape. Returns 0, BF_OUT_OF_MEMORY, or the status the
+// run ended with.
+static int run_on_tape(brainfuck_t fuck, bf_io *io)
+{
+    pthread_once(&tape_handler_once, &install_tape_handler);
+
+    bf_tape tape;
+    void *base = mmap(NULL, TAPE_RESERVE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        return BF_OUT_OF_MEMORY;
+    }
+    tape.base = (uint8_t *)base;
+    uint8_t *start = tape.base + TAPE_START;
+    if (mprotect(start - TAPE_CHUNK, TAPE_CHUNK, PROT_READ) != 0
+        || mprotect(start, TAPE_CHUNK, PROT_READ | PROT_WRITE) != 0) {
+        munmap(base, TAPE_RESERVE);
+        return BF_OUT_OF_MEMORY;
+    }
+
+    int status = sigsetjmp(tape.escape, 1);
+    if (status == 0) {
+        current_tape = &tape;
+        fuck((bf_cell *)start, io);
+    }
+    current_tape = NULL;
+    munmap(base, TAPE_RESERVE);
+    return status;
+}
+
 #endif // BRAINFUCK_JIT_UNIX_H
 
@@ -27,37 +27,40 @@
 #include <Windows.h>
 #include <memoryapi.h>
 
-// Windows can't just use the VirtualAlloc block, if it isn't volatile it gets optimized into oblivion.
-static unsigned char *alloc_opcodes(size_t len)
+// Maps a section of virtual memory using VirtualAlloc.
+static raw_opcode *alloc_opcodes(size_t len)
 {
-    return (unsigned char *)malloc(1, len);
+#ifdef UNSAFE // -DUNSAFE: Writes in RWX mode. Slightly faster, but less safe
+    DWORD prot = PAGE_EXECUTE_READWRITE;
+#else
+    DWORD prot = PAGE_READWRITE;
+#endif
+    return (raw_opcode *)VirtualAlloc(NULL, len, MEM_RESERVE | MEM_COMMIT, prot);
 }
 
-// Maps a section of virtual memory using VirtualAlloc, copies the opcodes into it, and runs it.
-// We need buf to be volatile because optimizations mess with it.
-static void run_opcodes(const unsigned char *restrict opcodes, size_t len, unsigned char *restrict cells)
+// Protects memory with R^X mode.
+static void protect_opcodes(raw_opcode *buf, size_t len)
 {
-    volatile unsigned char *buf =
-        (volatile unsigned char *)VirtualAlloc(NULL, len, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
-    if (buf) {
-        // Copy over the opcodes
-        memcpy((void *)buf, opcodes, len);
-        // Protect memory with R^X mode
-        DWORD old;
-        VirtualProtect((void *)buf, len, PAGE_EXECUTE_READ, &old);
-        brainfuck_t fuck = (brainfuck_t)buf;
-        fuck(cells, &putchar, &getchar);
-        VirtualFree((void *)buf, len, MEM_RELEASE);
-    } else {
-        puts("Out of memory!");
-    }
+#ifdef UNSAFE
+    (void)buf;
+    (void)len;
+#else
+    DWORD old;
+    VirtualProtect((void *)buf, len, PAGE_EXECUTE_READ, &old);
+    FlushInstructionCache(GetCurrentProcess(), (void *)buf, len);
+#endif
 }
 
 // Frees the opcodes buffer
-static void dealloc_opcodes(unsigned char *buf, size_t len)
+static void dealloc_opcodes(raw_opcode *buf, size_t len)
 {
     (void)len;
-    free(buf);
+    VirtualFree((void *)buf, 0, MEM_RELEASE);
 }
 
+// There is no guard page tape on Windows, so there is no run_on_tape() either. Programs
+// that analyze_tape() couldn't bound run on the same heap tape as checked builds: 65536
+// cells with a little padding on either side. An unchecked program that runs off it
+// corrupts the heap, so build with -DCHECKED to run untrusted programs here.
+
 #endif // BRAINFUCK_WINDOWS_JIT_H
@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2019 easyaspi314
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ */
+
+/// brainfuck-jit-perf-linux.h: Telling Linux perf about the generated code.
+///
+/// perf only knows about code that came from a file, so JIT code shows up as [unknown].
+/// It has two ways around that, and brainfuck_set_perf_map() turns on either:
+///
+///  - /tmp/perf-<pid>.map is a text file of "start size name" lines, which perf report
+///    reads as symbols.
+///  - jit-<pid>.dump has a copy of the code as well, for `perf inject --jit`. perf finds
+///    it because we map it executable, and matches its timestamps to the recording, so
+///    it has to use CLOCK_MONOTONIC (`perf record -k mono`).
+///
+/// A program is listed as its init code, each top-level loop, the straight-line code in
+/// between, and its cleanup code. Loops are named after where they are in the source,
+/// like bf:loop@120-455, and straight-line code after where it starts, like bf:code@456.
+/// -DTIERED and -DLAZY list each loop as it is compiled.
+#ifndef BRAINFUCK_JIT_PERF_LINUX_H
+#define BRAINFUCK_JIT_PERF_LINUX_H
+#ifndef __linux__
+#   error "This code is for Linux."
+#endif
+
+#ifndef BRAINFUCK_JIT_C
+#   error "This file is only to be included from brainfuck-jit.c"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#define HAVE_PERF_MAP 1
+
+#if defined(__x86_64__)
+#   define PERF_ELF_MACHINE 62 // EM_X86_64
+#elif defined(__i386__)
+#   define PERF_ELF_MACHINE 3 // EM_386
+#elif defined(__aarch64__)
+#   define PERF_ELF_MACHINE 183 // EM_AARCH64
+#else
+#   define PERF_ELF_MACHINE 40 // EM_ARM
+#endif
+
+// The jitdump format, from tools/perf/Documentation/jitdump-specification.txt.
+#define JITDUMP_MAGIC 0x4A695444 // "JiTD"
+#define JITDUMP_CODE_LOAD 0
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t total_size;
+    uint32_t elf_mach;
+    uint32_t pad1;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+} bf_jitdump_header;
+
+// Followed by the name with its nul, and then the code.
+typedef struct {
+    uint32_t id;
+    uint32_t total_size;
+    uint64_t timestamp;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t code_addr;
+    uint64_t code_size;
+    uint64_t code_index;
+} bf_jitdump_code_load;
+
+// Where perf output goes. Opened by brainfuck_set_perf_map(), before any threads.
+static FILE *perf_map_file = NULL;
+static int perf_jitdump_fd = -1;
+// Every code load in the jitdump gets its own number.
+static uint64_t perf_code_index = 0;
+
+static bool perf_enabled(void)
+{
+    return perf_map_file != NULL || perf_jitdump_fd >= 0;
+}
+
+static uint64_t perf_timestamp(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+// Opens the jitdump file and writes its header. Returns -1 if we can't.
+static int open_jitdump(void)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/jit-%d.dump", (int)getpid());
+    int fd = open(path, O_CREAT | O_TRUNC | O_RDWR | O_APPEND, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    bf_jitdump_header header = {
+        JITDUMP_MAGIC, 1, sizeof(bf_jitdump_header), PERF_ELF_MACHINE, 0, (uint32_t)getpid(),
+        perf_timestamp(), 0
+    };
+    // perf record sees this mapping, which is how perf inject finds the file. It stays
+    // mapped until we exit.
+    void *marker = MAP_FAILED;
+    if (write(fd, &header, sizeof(header)) == (ssize_t)sizeof(header)) {
+        marker = mmap(NULL, (size_t)sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+    }
+    if (marker == MAP_FAILED) {
+        close(fd);
+        unlink(path);
+        return -1;
+    }
+    return fd;
+}
+
+static void start_perf_map(int flags)
+{
+    if (!(flags & BRAINFUCK_PERF_MAP) && perf_map_file) {
+        fclose(perf_map_file);
+        perf_map_file = NULL;
+    } else if ((flags & BRAINFUCK_PERF_MAP) && !perf_map_file) {
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/perf-%d.map", (int)getpid());
+        perf_map_file = fopen(path, "a");
+    }
+    if (!(flags & BRAINFUCK_PERF_JITDUMP) && perf_jitdump_fd >= 0) {
+        close(perf_jitdump_fd);
+        perf_jitdump_fd = -1;
+    } else if ((flags & BRAINFUCK_PERF_JITDUMP) && perf_jitdump_fd < 0) {
+        perf_jitdump_fd = open_jitdump();
+    }
+}
+
+// Tells perf that size bytes at code are called name. Thread safe.
+static void perf_code(const void *code, size_t size, const char *name)
+{
+    if (size == 0) {
+        return;
+    }
+    if (perf_map_file) {
+        // One line per call, so threads don't mix them up.
+        fprintf(perf_map_file, "%lx %zx %s\n", (unsigned long)(uintptr_t)code, size, name);
+        fflush(perf_map_file);
+    }
+    if (perf_jitdump_fd >= 0) {
+        size_t name_len = strlen(name) + 1;
+        size_t total = sizeof(bf_jitdump_code_load) + name_len + size;
+        uint8_t *record = (uint8_t *)malloc(total);
+        if (record == NULL) {
+            return;
+        }
+        bf_jitdump_code_load load = {
+            JITDUMP_CODE_LOAD, (uint32_t)total, perf_timestamp(), (uint32_t)getpid(),
+            (uint32_t)syscall(SYS_gettid), (uint64_t)(uintptr_t)code, (uint64_t)(uintptr_t)code,
+            size, __atomic_fetch_add(&perf_code_index, 1, __ATOMIC_RELAXED)
+        };
+        memcpy(record, &load, sizeof(load));
+        memcpy(record + sizeof(load), name, name_len);
+        memcpy(record + sizeof(load) + name_len, code, size);
+        // O_APPEND keeps each record in one piece.
+        if (write(perf_jitdump_fd, record, total) != (ssize_t)total) {
+            bf_log("perf: jitdump write failed\n");
+        }
+        free(record);
+    }
+}
+
+// Whether we know where the loop with the given number is in the source. The copy
+// loops checked builds put back aren't anywhere.
+static bool perf_loop_known(const brainfuck_program *restrict program, size_t loop)
+{
+    return loop < program->loop_spans_len && program->loop_spans[loop].end != UINT32_MAX;
+}
+
+// Names the loop with the given number, counting every start op in the program.
+static void perf_loop(const brainfuck_program *restrict program, size_t loop, const void *code, size_t size)
+{
+    char name[64];
+    if (perf_loop_known(program, loop)) {
+        snprintf(name, sizeof(name), "bf:loop@%u-%u", program->loop_spans[loop].start, program->loop_spans[loop].end);
+    } else {
+        snprintf(name, sizeof(name), "bf:loop#%zu", loop);
+    }
+    perf_code(code, size, name);
+}
+
+// -DTIERED compiles nothing up front.
+#ifndef TIERED
+// A top-level loop in a program being compiled.
+typedef struct {
+    // Where it is in the code, in raw_opcodes.
+    size_t start;
+    size_t end;
+    // Its number for perf_loop().
+    size_t loop;
+} bf_perf_range;
+
+// What prepare_opcodes() has compiled so far.
+typedef struct {
+    // NULL if perf is off.
+    bf_perf_range *ranges;
+    size_t len;
+    size_t init_len;
+    // How many start ops we passed, and where the open top-level loop ends in the IR.
+    size_t loops;
+    size_t loop_end;
+    bool in_loop;
+} bf_perf_tracker;
+
+// Starts tracking a program after its init code.
+static void perf_begin(bf_perf_tracker *restrict perf, const brainfuck_program *restrict program, size_t pos)
+{
+    memset(perf, 0, sizeof(*perf));
+    perf->init_len = pos;
+    if (perf_enabled()) {
+        size_t loops = 0;
+        for (size_t i = 0; i < program->opcodes_len; i++) {
+            loops += program->opcodes[i].op == bf_opcode_start;
+        }
+        perf->ranges = (bf_perf_range *)calloc(loops + 1, sizeof(bf_perf_range));
+    }
+}
+
+// Called before ir[i] is compiled at pos, since the backends clobber the jumps.
+static void perf_track(bf_perf_tracker *restrict perf, const bf_opcode *restrict ir, size_t i, size_t pos)
+{
+    if (perf->ranges == NULL) {
+        return;
+    }
+    if (perf->in_loop && i > perf->loop_end) {
+        perf->ranges[perf->len++].end = pos;
+        perf->in_loop = false;
+    }
+    if (ir[i].op == bf_opcode_start) {
+        if (!perf->in_loop) {
+            perf->ranges[perf->len].start = pos;
+            perf->ranges[perf->len].loop = perf->loops;
+            perf->loop_end = i + (size_t)ir[i].amount;
+            perf->in_loop = true;
+        }
+        ++perf->loops;
+    }
+}
+
+// Lists the finished program, whose cleanup code is from pos to end.
+static void perf_end(bf_perf_tracker *restrict perf, const brainfuck_program *restrict program, const raw_opcode *code, size_t pos, size_t end)
+{
+    if (perf->ranges == NULL) {
+        if (perf_enabled()) {
+            perf_code(code, end * sizeof(raw_opcode), "bf:code");
+        }
+        return;
+    }
+    if (perf->in_loop) {
+        perf->ranges[perf->len++].end = pos;
+    }
+    char name[64];
+    perf_code(code, perf->init_len * sizeof(raw_opcode), "bf:init");
+    size_t at = perf->init_len;
+    uint32_t source = 0;
+    for (size_t i = 0; i <= perf->len; i++) {
+        // The straight-line code up to the loop, or up to the cleanup after the last one.
+        size_t next = i < perf->len ? perf->ranges[i].start : pos;
+        snprintf(name, sizeof(name), "bf:code@%u", source);
+        perf_code(code + at, (next - at) * sizeof(raw_opcode), name);
+        if (i == perf->len) {
+            break;
+        }
+        bf_perf_range *range = &perf->ranges[i];
+        perf_loop(program, range->loop, code + range->start, (range->end - range->start) * sizeof(raw_opcode));
+        at = range->end;
+        if (perf_loop_known(program, range->loop)) {
+            source = program->loop_spans[range->loop].end + 1;
+        }
+    }
+    perf_code(code + pos, (end - pos) * sizeof(raw_opcode), "bf:exit");
+    free(perf->ranges);
+    perf->ranges = NULL;
+}
+#endif
+
+#endif // BRAINFUCK_JIT_PERF_LINUX_H
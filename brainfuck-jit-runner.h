@@ -1,24 +1,121 @@
 
-// Allocates a buffer using mmap, copies opcodes, marks executable, and runs.
-static void run_opcodes(bf_opcode *restrict ir, size_t len)
+#ifdef LAZY
+// -DLAZY: The program being run on this thread, for compile_lazy_loop().
+static bf_thread_local const brainfuck_program *lazy_program;
+
+// -DLAZY: Where the stub of a top-level loop calls the first time it runs. Compiles the
+// loop at opcodes[index], points the stub's slot at it, and runs it.
+static bf_cell *compile_lazy_loop(bf_cell *cell, bf_io *io, uint32_t index)
+{
+    const brainfuck_program *program = lazy_program;
+    const bf_opcode *start = &program->opcodes[index];
+    bf_loop_code *loop = &program->loop_code[start->offset];
+    size_t code_len = 0;
+    void *code = compile_loop(start, &code_len);
+    if (code == NULL) {
+        end_run(io, BF_OUT_OF_MEMORY);
+    }
+    bf_log("lazy: compiled loop %d at %u, %zu bytes\n", start->offset, index, code_len);
+    void *stub = (void *)&compile_lazy_loop;
+    void *old = publish_loop(&loop->code, stub, code);
+    if (old == stub) {
+        loop->code_len = code_len;
+#ifdef HAVE_PERF_MAP
+        if (perf_enabled()) {
+            size_t number = 0;
+            for (uint32_t i = 0; i < index; i++) {
+                number += program->opcodes[i].op == bf_opcode_start;
+            }
+            perf_loop(program, number, code, code_len);
+        }
+#endif
+    } else {
+        // Another run got there first.
+        dealloc_opcodes((raw_opcode *)code, code_len);
+        code = old;
+    }
+    return ((brainfuck_t)code)(cell, io);
+}
+
+// -DLAZY: Numbers the top-level loops in the offset of their start op, points their
+// slots at compile_lazy_loop(), and returns the worst case size of the code with a stub
+// in place of each of them.
+static size_t prepare_lazy_loops(brainfuck_program *restrict program)
+{
+    bf_opcode *ir = program->opcodes;
+    size_t len = program->opcodes_len, loops = 0;
+    size_t memlen = INIT_LEN + CLEANUP_LEN;
+    for (size_t i = 0; i < len; i++) {
+        if (ir[i].op == bf_opcode_start) {
+            ir[i].offset = (int32_t)loops++;
+            memlen += MAX_LAZY_CALL_LEN;
+            i += ir[i].amount;
+        } else {
+            memlen += max_opcode_len(&ir[i]);
+        }
+    }
+    program->loop_code = (bf_loop_code *)calloc(loops + 1, sizeof(bf_loop_code));
+    if (program->loop_code == NULL) {
+        return 0;
+    }
+    for (size_t i = 0; i < loops; i++) {
+        program->loop_code[i].code = (void *)&compile_lazy_loop;
+    }
+    program->loop_code_len = loops;
+    return memlen;
+}
+#endif
+
+// Allocates a buffer using mmap, compiles the opcodes into it, and marks it executable.
+static bool prepare_opcodes(brainfuck_program *restrict program)
 {
+    bf_opcode *ir = program->opcodes;
+    size_t len = program->opcodes_len;
     size_t i = 0, pos = 0;
-    size_t memlen = len * MAX_INSN_LEN + INIT_LEN + CLEANUP_LEN;
+#ifdef LAZY
+    size_t memlen = prepare_lazy_loops(program);
+    if (memlen == 0) {
+        return false;
+    }
+#else
+    size_t memlen = max_code_len(ir, len);
+#endif
     raw_opcode *opcodes = alloc_opcodes(memlen);
     if (opcodes == NULL) {
-        return;
+        return false;
     }
 
     write_init_code(opcodes, &pos);
+#ifdef HAVE_PERF_MAP
+    bf_perf_tracker perf;
+    perf_begin(&perf, program, pos);
+#endif
     while (i < len) {
+#ifdef LAZY
+         // The loop body stays as IR until the stub runs.
+         if (ir[i].op == bf_opcode_start) {
+             write_lazy_call(&program->loop_code[ir[i].offset].code, (uint32_t)i, opcodes, &pos);
+             i += (size_t)ir[i].amount + 1;
+             continue;
+         }
+#endif
+#ifdef HAVE_PERF_MAP
+         perf_track(&perf, ir, i, pos);
+#endif
          compile_opcode(&ir[i], opcodes, &pos);
          ++i;
     }
+#ifdef HAVE_PERF_MAP
+    size_t cleanup_pos = pos;
+#endif
     write_cleanup_code(opcodes, &pos);
-#ifdef DEBUG
+// With -DLAZY, the loops aren't in it, so there isn't much to look at.
+#if defined(DEBUG) && !defined(LAZY)
     FILE *f = fopen("bf.s", "w");
     // asm file with .byte directives
     fprintf(f,  "        .text\n"
+                // The loop alignment is relative to the start.
+                "        .p2align 6\n"
                 "        .globl fuck\n"
                 "fuck:\n");
     for (i = 0; i < pos; i++) {
@@ -28,17 +125,66 @@ static void run_opcodes(bf_opcode *restrict ir, size_t len)
 #endif
     // Mark our region as R^X
     protect_opcodes(opcodes, memlen);
+#ifdef HAVE_PERF_MAP
+    perf_end(&perf, program, opcodes, cleanup_pos, pos);
+#endif
 
-    // Cast to a function pointer
-    brainfuck_t fuck = (brainfuck_t)opcodes;
-    // and fuck it!
-    uint8_t *cells = (uint8_t *)calloc(1, 65535), *cell = cells;
+    program->code = opcodes;
+    program->code_len = memlen;
+    program->code_size = pos * sizeof(raw_opcode);
 
-    fuck(cell, &putchar, &getchar);
+#ifndef LAZY
+    // compile_opcode() clobbers the jump offsets, and we don't need the IR anymore.
+    free(program->opcodes);
+    program->opcodes = NULL;
+#endif
+    return true;
+}
 
-    free(cells);
+// Runs the compiled code on a fresh tape.
+static int run_opcodes(brainfuck_program *restrict program, int (*putchar_ptr)(int), int (*getchar_ptr)(void))
+{
+    // Cast to a function pointer
+    brainfuck_t fuck = (brainfuck_t)program->code;
+    // -O0 is unbuffered, so flush after every byte.
+    bf_io *io = alloc_io(putchar_ptr, getchar_ptr, program->optlevel < 1);
+    if (!io) {
+        return BF_OUT_OF_MEMORY;
+    }
+#ifdef PROFILE
+    if (!start_profile(program, io)) {
+        dealloc_io(io);
+        return BF_OUT_OF_MEMORY;
+    }
+#endif
 
-    // cleanup
-    dealloc_opcodes(opcodes, memlen);
+    // and fuck it!
+#ifdef LAZY
+    lazy_program = program;
+#endif
+    int status = run_on_fresh_tape(program, fuck, io);
+
+#ifdef PROFILE
+    finish_profile(program, io);
+#endif
+    dealloc_io(io);
+    return status;
+}
 
+// Unmaps the compiled code.
+static void release_opcodes(brainfuck_program *restrict program)
+{
+    if (program->code) {
+        dealloc_opcodes((raw_opcode *)program->code, program->code_len);
+        program->code = NULL;
+    }
+#ifdef LAZY
+    for (size_t i = 0; i < program->loop_code_len; i++) {
+        if (program->loop_code[i].code != (void *)&compile_lazy_loop) {
+            dealloc_opcodes((raw_opcode *)program->loop_code[i].code, program->loop_code[i].code_len);
+        }
+    }
+    free(program->loop_code);
+    program->loop_code = NULL;
+#endif
 }
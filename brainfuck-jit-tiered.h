@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2019 easyaspi314
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ */
+
+/// brainfuck-jit-tiered.h: -DTIERED replacement for brainfuck-jit-runner.h.
+///
+/// Nothing is compiled up front. The program starts in a simple interpreter over the IR,
+/// which counts how many times each loop jumps back to its start. When a loop does that
+/// TIER_THRESHOLD times, just that loop is compiled on its own, with the same init and
+/// cleanup code as a whole program, and the interpreter calls it from the loop head from
+/// then on. The generated code returns the pointer where the loop left it, and the
+/// interpreter carries on after the ']'.
+///
+/// The counts are per run, but the compiled loops belong to the program, so the other
+/// runs pick them up when their own counts get there.
+#ifndef BRAINFUCK_JIT_TIERED_H
+#define BRAINFUCK_JIT_TIERED_H
+
+#ifndef BRAINFUCK_JIT_C
+#   error "This file is only to be included from brainfuck-jit.c"
+#endif
+#include <string.h>
+
+// How many times a loop jumps back in the interpreter before we compile it.
+#ifndef TIER_THRESHOLD
+#   define TIER_THRESHOLD 1000
+#endif
+
+// A loop as one run sees it.
+typedef struct {
+    // How many times the interpreter went back to the start.
+    uint32_t count;
+    // The compiled loop, once it is hot.
+    brainfuck_t code;
+} bf_tier_state;
+
+// What interpret_tiered() runs, since run_on_fresh_tape() only passes it the tape and io.
+static bf_thread_local struct {
+    const brainfuck_program *program;
+    bf_tier_state *loops;
+} tiered_run;
+
+// The loops are numbered in the offset of their start op, which is unused in the IR.
+static bool prepare_opcodes(brainfuck_program *restrict program)
+{
+    size_t loops = 0;
+    for (size_t i = 0; i < program->opcodes_len; i++) {
+        if (program->opcodes[i].op == bf_opcode_start) {
+            program->opcodes[i].offset = (int32_t)loops++;
+        }
+    }
+    program->loop_code = (bf_loop_code *)calloc(loops + 1, sizeof(bf_loop_code));
+    if (program->loop_code == NULL) {
+        return false;
+    }
+    program->loop_code_len = loops;
+    return true;
+}
+
+// Gets the native code for a hot loop, compiling it unless another run already has.
+static brainfuck_t tier_up(const brainfuck_program *program, const bf_opcode *start)
+{
+    bf_loop_code *loop = &program->loop_code[start->offset];
+    void *code = publish_loop(&loop->code, NULL, NULL);
+    if (code == NULL) {
+        size_t code_len = 0;
+        raw_opcode *mine = compile_loop(start, &code_len);
+        if (mine == NULL) {
+            // Keep interpreting it.
+            return NULL;
+        }
+        bf_log("tiered: compiled loop %d at %td, %zu bytes\n", start->offset, start - program->opcodes, code_len);
+        code = publish_loop(&loop->code, NULL, mine);
+        if (code == NULL) {
+            loop->code_len = code_len;
+            code = mine;
+#ifdef HAVE_PERF_MAP
+            // The loops are numbered the same way.
+            perf_loop(program, (size_t)start->offset, code, code_len);
+#endif
+        } else {
+            // Someone else was faster.
+            dealloc_opcodes(mine, code_len);
+        }
+    }
+    return (brainfuck_t)code;
+}
+
+// Interprets the IR, and switches to native code for the hot loops.
+static bf_cell *interpret_tiered(bf_cell *cell, bf_io *io)
+{
+    const brainfuck_program *program = tiered_run.program;
+    bf_tier_state *loops = tiered_run.loops;
+    const bf_opcode *op = program->opcodes, *end = program->opcodes + program->opcodes_len;
+    for (; op < end; ++op) {
+#ifdef PROFILE
+        // Loops count in their body, the rest as they run.
+        if (op->site != 0 && op->op != bf_opcode_start) {
+            ++io->profile_counts[op->site - 1];
+        }
+#endif
+        switch (op->op) {
+        case bf_opcode_add:
+            cell[op->offset] += op->amount;
+            break;
+        case bf_opcode_move:
+            cell += op->amount;
+            break;
+        case bf_opcode_put:
+            *io->out++ = (uint8_t)cell[op->offset];
+            if (io->out == io->out_end) {
+                io->flush(io);
+            }
+            break;
+        case bf_opcode_get:
+            if (io->in == io->in_end) {
+                io->refill(io);
+            }
+            cell[op->offset] = *io->in++;
+            break;
+        case bf_opcode_clear:
+            cell[op->offset] = 0;
+            break;
+        case bf_opcode_copy_mul:
+            cell[op->offset + copy_mul_target(op->amount)] += (bf_cell)(copy_mul_factor(op->amount) * cell[op->offset]);
+            break;
+        case bf_opcode_scan:
+            while (*cell) {
+                cell += op->amount;
+            }
+            break;
+        case bf_opcode_check:
+            if (cell + op->amount < io->tape_start || cell + op->offset >= io->tape_end) {
+                io->tape_error(io);
+            }
+            break;
+        case bf_opcode_start:
+            if (*cell == 0) {
+                op += op->amount;
+            } else if (loops[op->offset].code) {
+                // Runs the whole loop, and leaves us on the ']'.
+                cell = loops[op->offset].code(cell, io);
+                op += op->amount;
+            }
+#ifdef PROFILE
+            else {
+                ++io->profile_counts[op->site - 1];
+            }
+#endif
+            break;
+        case bf_opcode_end: {
+            if (*cell == 0) {
+                break;
+            }
+            const bf_opcode *start = op + op->amount;
+            bf_tier_state *loop = &loops[start->offset];
+            if (++loop->count == TIER_THRESHOLD) {
+                loop->code = tier_up(program, start);
+            }
+            if (loop->code) {
+                // The cell isn't zero, so this picks up with the next iteration.
+                cell = loop->code(cell, io);
+            } else {
+                op = start;
+#ifdef PROFILE
+                ++io->profile_counts[op->site - 1];
+#endif
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    io->flush(io);
+    return cell;
+}
+
+// Runs the program on a fresh tape, in the interpreter until the loops get hot.
+static int run_opcodes(brainfuck_program *restrict program, int (*putchar_ptr)(int), int (*getchar_ptr)(void))
+{
+    // -O0 is unbuffered, so flush after every byte.
+    bf_io *io = alloc_io(putchar_ptr, getchar_ptr, program->optlevel < 1);
+    bf_tier_state *loops = (bf_tier_state *)calloc(program->loop_code_len + 1, sizeof(bf_tier_state));
+    if (!io || !loops) {
+        free(io);
+        free(loops);
+        return BF_OUT_OF_MEMORY;
+    }
+#ifdef PROFILE
+    if (!start_profile(program, io)) {
+        free(loops);
+        dealloc_io(io);
+        return BF_OUT_OF_MEMORY;
+    }
+#endif
+    tiered_run.program = program;
+    tiered_run.loops = loops;
+
+    // Same tapes as brainfuck-jit-runner.h, since the compiled loops need them.
+    int status = run_on_fresh_tape(program, &interpret_tiered, io);
+
+#ifdef PROFILE
+    finish_profile(program, io);
+#endif
+    free(loops);
+    dealloc_io(io);
+    return status;
+}
+
+// Unmaps the compiled loops.
+static void release_opcodes(brainfuck_program *restrict program)
+{
+    for (size_t i = 0; i < program->loop_code_len; i++) {
+        if (program->loop_code[i].code) {
+            dealloc_opcodes((raw_opcode *)program->loop_code[i].code, program->loop_code[i].code_len);
+        }
+    }
+    free(program->loop_code);
+    program->loop_code = NULL;
+}
+
+#endif // BRAINFUCK_JIT_TIERED_H
@@ -33,15 +33,104 @@
 #   define RBX "rbx"
 #endif
 
-// cmp + jne = 9 bytes
-#define MAX_INSN_LEN 16
+#if CELL_BITS == 8
+#   define CELL_PTR "byte ptr"
+#   define CELL_SUFFIX "b"
+#   define CELL_PCMPEQ 0x74
+#elif CELL_BITS == 16
+#   define CELL_PTR "word ptr"
+#   define CELL_SUFFIX "w"
+#   define CELL_PCMPEQ 0x75
+#else
+#   define CELL_PTR "dword ptr"
+#   define CELL_SUFFIX "d"
+#   define CELL_PCMPEQ 0x76
+#endif
+
+// Which calling convention the generated code follows. Part of the code cache key.
+#if defined(JIT_I386)
+#   define JIT_ABI "i386-cdecl"
+#elif defined(_WIN32)
+#   define JIT_ABI "x86_64-win64"
+#else
+#   define JIT_ABI "x86_64-sysv"
+#endif
+
+// 26 bytes covers a multiply, plus the loop edges spilling the whole register cache
+#define MAX_INSN_LEN (26 + MAX_SPILL_LEN)
+#ifdef JIT_I386
 // size of init[]
-#define INIT_LEN 14
-// size of cleanup[]
-#define CLEANUP_LEN 6
+#   define INIT_LEN 54
+// where the flush and refill stubs are in init[]
+#   define FLUSH_STUB_POS 19
+#   define REFILL_STUB_POS 35
+// size of cleanup[] and the flush call
+#   define CLEANUP_LEN 15
+#else
+#   define INIT_LEN 126
+#   define FLUSH_STUB_POS 31
+#   define REFILL_STUB_POS 76
+#   define CLEANUP_LEN 23
+#endif
+// The AVX2 scan, see write_scan(), and the spills before it
+#define MAX_SCAN_LEN (49 + MAX_SPILL_LEN)
+// A bounds check with the Windows shadow space, see write_check()
+#define MAX_CHECK_LEN 44
+// -DLAZY works here, see write_lazy_call(). The stub with the Windows shadow space, and
+// the spills before it
+#define HAVE_LAZY_LOOPS 1
+#define MAX_LAZY_CALL_LEN (62 + MAX_SPILL_LEN)
+// -DPROFILE: The i386 counter, see write_profile_count()
+#define MAX_PROFILE_LEN 20
 typedef uint8_t raw_opcode;
 
+#define JIT_CPU_AVX2 1
+
+// The optional instruction sets we use. The ELF backend writes a binary for some
+// other machine, so it sticks to the SSE2 baseline.
+static uint32_t jit_cpu_features(void)
+{
+#if !defined(JIT_I386) && !defined(ELF_BACKEND) && defined(__GNUC__)
+    if (__builtin_cpu_supports("avx2")) {
+        return JIT_CPU_AVX2;
+    }
+#endif
+    return 0;
+}
+
+static void reset_reg_cache(void);
+
+// Branch relaxation: Loops are written with rel32 jumps, and when one closes with a body
+// short enough for rel8, the body is moved back over the spare bytes. The only things in
+// a body that point outside of it are the calls to the stubs, so we remember where the
+// recent ones are to fix them up. A short body only has room for 25 of them.
+//
+// Aligned loop bodies (see loop_padding()) can only move by whole LOOP_ALIGN blocks, so
+// whatever is left over becomes padding.
+#define MAX_SHORT_BODY 125
+#define RECENT_CALLS 32
+static bf_thread_local struct {
+    // Where the rel32 of each call is, as a ring buffer.
+    size_t pos[RECENT_CALLS];
+    size_t count;
+    // Where the last aligned loop body starts, or 0.
+    size_t aligned_body;
+} recent_calls;
+
+// The cell the zero flag was last set from, relative to rbx. When that is the current
+// cell, the loop tests branch on the flag as it is instead of comparing again.
+static bf_thread_local struct {
+    bool valid;
+    int32_t offset;
+} zero_flag;
+
 // Writes the initialization code for our JIT.
+//
+// The generated code is called as fuck(cells, io). The output and input buffer pointers
+// live in registers, and each '.' and ',' uses them inline. When a buffer fills up or runs
+// dry, we call the flush or refill stub. They sit in the init code right after the
+// prologue, so every call to them is a simple relative call to FLUSH_STUB_POS or
+// REFILL_STUB_POS.
 static void write_init_code(uint8_t *restrict out, size_t *restrict pos)
 {
 
@@ -49,83 +138,673 @@ static void write_init_code(uint8_t *restrict out, size_t *restrict pos)
 #ifdef JIT_I386
 
     // cdecl calling conventions state that our parameters will be at esp+4.
-    // We don't have many registers on i386, so we leave the putchar
-    // and getchar pointers on the stack.
+    // We don't have many registers on i386, so we compare against io->out_end and
+    // io->in_end in memory. ebp is the input pointer.
     const uint8_t init[] = {
         // Set up our parameterz.
         // push ebp
         0x55,
         // push ebx
         0x53,
-        // mov ebx, dword ptr[esp + 12]
-        0x8b, 0x5c, 0x24, 0x0c,
+        // push esi
+        0x56,
+        // push edi
+        0x57,
+        // mov ebx, dword ptr[esp + 20] // ebx = cells
+        0x8b, 0x5c, 0x24, 0x14,
+        // mov edi, dword ptr[esp + 24] // edi = io
+        0x8b, 0x7c, 0x24, 0x18,
+        // mov esi, dword ptr[edi] // esi = io->out
+        0x8b, 0x37,
+        // mov ebp, dword ptr[edi + 8] // ebp = io->in
+        0x8b, 0x6f, 0x08,
+        // jmp .Lstart
+        0xeb, 0x23,
+
+        // .Lflush:
+        // Save the cached cells, see reg_cache.
+        // push ecx
+        0x51,
+        // push edx
+        0x52,
+        // mov dword ptr[edi], esi
+        0x89, 0x37,
+        // push edi
+        0x57,
+        // call dword ptr[edi + 16] // io->flush(io)
+        0xff, 0x57, 0x10,
+        // add esp, 4
+        0x83, 0xc4, 0x04,
+        // mov esi, dword ptr[edi]
+        0x8b, 0x37,
+        // pop edx
+        0x5a,
+        // pop ecx
+        0x59,
+        // ret
+        0xc3,
+
+        // .Lrefill:
+        // push ecx
+        0x51,
+        // push edx
+        0x52,
+        // mov dword ptr[edi], esi
+        0x89, 0x37,
+        // push edi
+        0x57,
+        // call dword ptr[edi + 20] // io->refill(io)
+        0xff, 0x57, 0x14,
+        // add esp, 4
+        0x83, 0xc4, 0x04,
+        // mov esi, dword ptr[edi]
+        0x8b, 0x37,
+        // mov ebp, dword ptr[edi + 8]
+        0x8b, 0x6f, 0x08,
+        // pop edx
+        0x5a,
+        // pop ecx
+        0x59,
+        // ret
+        0xc3,
+        // .Lstart:
     };
-    // putchar: esp + 16
-    // getchar: esp + 20
     bf_log(
         "fuck:\n"
         "        push    ebp\n"
         "        push    ebx\n"
-        "        mov     ebx, dword ptr[esp + 12]\n"
+        "        push    esi\n"
+        "        push    edi\n"
+        "        mov     ebx, dword ptr[esp + 20]\n"
+        "        mov     edi, dword ptr[esp + 24]\n"
+        "        mov     esi, dword ptr[edi]\n"
+        "        mov     ebp, dword ptr[edi + 8]\n"
+        "        jmp     .Lstart\n"
+        ".Lflush:\n"
+        "        push    ecx\n"
+        "        push    edx\n"
+        "        mov     dword ptr[edi], esi\n"
+        "        push    edi\n"
+        "        call    dword ptr[edi + 16]\n"
+        "        add     esp, 4\n"
+        "        mov     esi, dword ptr[edi]\n"
+        "        pop     edx\n"
+        "        pop     ecx\n"
+        "        ret\n"
+        ".Lrefill:\n"
+        "        push    ecx\n"
+        "        push    edx\n"
+        "        mov     dword ptr[edi], esi\n"
+        "        push    edi\n"
+        "        call    dword ptr[edi + 20]\n"
+        "        add     esp, 4\n"
+        "        mov     esi, dword ptr[edi]\n"
+        "        mov     ebp, dword ptr[edi + 8]\n"
+        "        pop     edx\n"
+        "        pop     ecx\n"
+        "        ret\n"
+        ".Lstart:\n"
     );
 
 #else // x86_64
 
-    // System V calling conventions dictate that the first three parameters are in rdi, rsi, and rdx.
-    // Windows calling conventions say that the first three parameters are rcx, rdx, and r8.
+    // System V calling conventions dictate that the first two parameters are in rdi and rsi.
+    // Windows calling conventions say that the first two parameters are rcx and rdx.
     //
     // Additionally, they both say that rbx, rbp, and r12-r15 are callee saved: In order to use them in your function,
     // you need to push and pop them. We use these registers to store data, as we don't need to worry about pushing and
     // popping in our own code.
+    //
+    // rbx = cells, r12 = io, r13 = io->out, r14 = io->out_end, r15 = io->in.
     const uint8_t init[] = {
         // Save the callee saved registers.
         // push rbx
         0x53,
         // push r12
         0x41, 0x54,
+        // push r13
+        0x41, 0x55,
         // push r14
         0x41, 0x56,
+        // push r15
+        0x41, 0x57,
 
 #ifdef _WIN32 // Windows ABI
-        // Save our function pointers into those registers. Otherwise, they will be overwritten
-        // when we call putchar/getchar. We also move the cells pointer around.
         // mov rbx, rcx // rbx = cells
         0x48, 0x89, 0xcb,
-        // mov r14, rdx // r14 = putchar
-        0x49, 0x89, 0xd6,
-        // mov r12, r8 // r12 = getchar
-        0x4d, 0x89, 0xc4,
-
+        // mov r12, rdx // r12 = io
+        0x49, 0x89, 0xd4,
 #else // System V ABI
-        // Save our function pointers into those registers. Otherwise, they will be overwritten
-        // when we call putchar/getchar. We also move the cells pointer around.
-        // mov rbx, rdi // rdi = cells
+        // mov rbx, rdi // rbx = cells
         0x48, 0x89, 0xfb,
-        // mov r14, rsi // r14 = putchar
-        0x49, 0x89, 0xf6,
-        // mov r12, rdx // r12 = getchar
-        0x49, 0x89, 0xd4,
+        // mov r12, rsi // r12 = io
+        0x49, 0x89, 0xf4,
 #endif // !_WIN32
+        // mov r13, qword ptr[r12] // r13 = io->out
+        0x4d, 0x8b, 0x2c, 0x24,
+        // mov r14, qword ptr[r12 + 8] // r14 = io->out_end
+        0x4d, 0x8b, 0x74, 0x24, 0x08,
+        // mov r15, qword ptr[r12 + 16] // r15 = io->in
+        0x4d, 0x8b, 0x7c, 0x24, 0x10,
+        // jmp .Lstart
+        0xeb, 0x5f,
+
+        // .Lflush:
+        // Save the cached cells, see reg_cache.
+        // push rcx
+        0x51,
+        // push rdx
+        0x52,
+        // push r8
+        0x41, 0x50,
+        // push r9
+        0x41, 0x51,
+        // push r10
+        0x41, 0x52,
+        // push r11
+        0x41, 0x53,
+        // Windows wants 32 bytes of shadow space. Either way, we need to realign the stack.
+#ifdef _WIN32
+        // sub rsp, 40
+        0x48, 0x83, 0xec, 0x28,
+#else
+        // sub rsp, 8
+        0x48, 0x83, 0xec, 0x08,
+#endif
+        // mov qword ptr[r12], r13
+        0x4d, 0x89, 0x2c, 0x24,
+#ifdef _WIN32
+        // mov rcx, r12
+        0x4c, 0x89, 0xe1,
+#else
+        // mov rdi, r12
+        0x4c, 0x89, 0xe7,
+#endif
+        // call qword ptr[r12 + 32] // io->flush(io)
+        0x41, 0xff, 0x54, 0x24, 0x20,
+        // mov r13, qword ptr[r12]
+        0x4d, 0x8b, 0x2c, 0x24,
+#ifdef _WIN32
+        // add rsp, 40
+        0x48, 0x83, 0xc4, 0x28,
+#else
+        // add rsp, 8
+        0x48, 0x83, 0xc4, 0x08,
+#endif
+        // pop r11
+        0x41, 0x5b,
+        // pop r10
+        0x41, 0x5a,
+        // pop r9
+        0x41, 0x59,
+        // pop r8
+        0x41, 0x58,
+        // pop rdx
+        0x5a,
+        // pop rcx
+        0x59,
+        // ret
+        0xc3,
+
+        // .Lrefill:
+        // push rcx
+        0x51,
+        // push rdx
+        0x52,
+        // push r8
+        0x41, 0x50,
+        // push r9
+        0x41, 0x51,
+        // push r10
+        0x41, 0x52,
+        // push r11
+        0x41, 0x53,
+        // Windows wants 32 bytes of shadow space. Either way, we need to realign the stack.
+#ifdef _WIN32
+        // sub rsp, 40
+        0x48, 0x83, 0xec, 0x28,
+#else
+        // sub rsp, 8
+        0x48, 0x83, 0xec, 0x08,
+#endif
+        // mov qword ptr[r12], r13
+        0x4d, 0x89, 0x2c, 0x24,
+#ifdef _WIN32
+        // mov rcx, r12
+        0x4c, 0x89, 0xe1,
+#else
+        // mov rdi, r12
+        0x4c, 0x89, 0xe7,
+#endif
+        // call qword ptr[r12 + 40] // io->refill(io)
+        0x41, 0xff, 0x54, 0x24, 0x28,
+        // mov r13, qword ptr[r12]
+        0x4d, 0x8b, 0x2c, 0x24,
+        // mov r15, qword ptr[r12 + 16]
+        0x4d, 0x8b, 0x7c, 0x24, 0x10,
+#ifdef _WIN32
+        // add rsp, 40
+        0x48, 0x83, 0xc4, 0x28,
+#else
+        // add rsp, 8
+        0x48, 0x83, 0xc4, 0x08,
+#endif
+        // pop r11
+        0x41, 0x5b,
+        // pop r10
+        0x41, 0x5a,
+        // pop r9
+        0x41, 0x59,
+        // pop r8
+        0x41, 0x58,
+        // pop rdx
+        0x5a,
+        // pop rcx
+        0x59,
+        // ret
+        0xc3,
+        // .Lstart:
     };
 
     bf_log(
         "fuck:\n"
         "        push    rbx\n"
         "        push    r12\n"
+        "        push    r13\n"
         "        push    r14\n"
+        "        push    r15\n"
 #ifdef _WIN32
         "        mov     rbx, rcx\n"
-        "        mov     r14, rdx\n"
-        "        mov     r12, r8\n"
+        "        mov     r12, rdx\n"
 #else
         "        mov     rbx, rdi\n"
-        "        mov     r14, rsi\n"
-        "        mov     r12, rdx\n"
+        "        mov     r12, rsi\n"
+#endif
+        "        mov     r13, qword ptr[r12]\n"
+        "        mov     r14, qword ptr[r12 + 8]\n"
+        "        mov     r15, qword ptr[r12 + 16]\n"
+        "        jmp     .Lstart\n"
+        ".Lflush:\n"
+        "        push    rcx\n"
+        "        push    rdx\n"
+        "        push    r8\n"
+        "        push    r9\n"
+        "        push    r10\n"
+        "        push    r11\n"
+#ifdef _WIN32
+        "        sub     rsp, 40\n"
+        "        mov     qword ptr[r12], r13\n"
+        "        mov     rcx, r12\n"
+#else
+        "        sub     rsp, 8\n"
+        "        mov     qword ptr[r12], r13\n"
+        "        mov     rdi, r12\n"
 #endif
+        "        call    qword ptr[r12 + 32]\n"
+        "        mov     r13, qword ptr[r12]\n"
+#ifdef _WIN32
+        "        add     rsp, 40\n"
+#else
+        "        add     rsp, 8\n"
+#endif
+        "        pop     r11\n"
+        "        pop     r10\n"
+        "        pop     r9\n"
+        "        pop     r8\n"
+        "        pop     rdx\n"
+        "        pop     rcx\n"
+        "        ret\n"
+        ".Lrefill:\n"
+        "        push    rcx\n"
+        "        push    rdx\n"
+        "        push    r8\n"
+        "        push    r9\n"
+        "        push    r10\n"
+        "        push    r11\n"
+#ifdef _WIN32
+        "        sub     rsp, 40\n"
+        "        mov     qword ptr[r12], r13\n"
+        "        mov     rcx, r12\n"
+#else
+        "        sub     rsp, 8\n"
+        "        mov     qword ptr[r12], r13\n"
+        "        mov     rdi, r12\n"
+#endif
+        "        call    qword ptr[r12 + 40]\n"
+        "        mov     r13, qword ptr[r12]\n"
+        "        mov     r15, qword ptr[r12 + 16]\n"
+#ifdef _WIN32
+        "        add     rsp, 40\n"
+#else
+        "        add     rsp, 8\n"
+#endif
+        "        pop     r11\n"
+        "        pop     r10\n"
+        "        pop     r9\n"
+        "        pop     r8\n"
+        "        pop     rdx\n"
+        "        pop     rcx\n"
+        "        ret\n"
+        ".Lstart:\n"
     );
 #endif // !JIT_I386
     memcpy(out + *pos, init, sizeof(init));
     *pos += sizeof(init);
+    reset_reg_cache();
+    recent_calls.count = 0;
+    recent_calls.aligned_body = 0;
+    zero_flag.valid = false;
+}
+
+// Calls the flush stub.
+static void write_flush_call(uint8_t *restrict out, size_t *restrict pos)
+{
+    bf_log("        call    .Lflush\n");
+    out[(*pos)++] = 0xe8;
+    recent_calls.pos[recent_calls.count++ % RECENT_CALLS] = *pos;
+    int32_t rel = (int32_t)(FLUSH_STUB_POS - (*pos + 4));
+    memcpy(out + *pos, &rel, sizeof(int32_t));
+    *pos += sizeof(int32_t);
+}
+
+// Calls the refill stub.
+static void write_refill_call(uint8_t *restrict out, size_t *restrict pos)
+{
+    bf_log("        call    .Lrefill\n");
+    out[(*pos)++] = 0xe8;
+    recent_calls.pos[recent_calls.count++ % RECENT_CALLS] = *pos;
+    int32_t rel = (int32_t)(REFILL_STUB_POS - (*pos + 4));
+    memcpy(out + *pos, &rel, sizeof(int32_t));
+    *pos += sizeof(int32_t);
+}
+
+// Writes the opcode of an instruction on a cell, given its byte form. The word and dword
+// forms of everything we use are the byte form + 1, and words need an operand size prefix.
+static void write_cell_opcode(uint8_t byte_op, uint8_t *restrict out, size_t *restrict pos)
+{
+#if CELL_BITS == 16
+    out[(*pos)++] = 0x66;
+#endif
+    out[(*pos)++] = CELL_BITS == 8 ? byte_op : byte_op | 1;
+}
+
+// Writes an immediate as wide as a cell.
+static void write_cell_imm(int32_t value, uint8_t *restrict out, size_t *restrict pos)
+{
+    memcpy(out + *pos, &value, CELL_BYTES);
+    *pos += CELL_BYTES;
+}
+
+// Writes the ModRM byte for the cell at rbx + offset, with reg in the reg field, followed
+// by the displacement if there is one.
+static void write_cell_operand(uint8_t reg, int32_t offset, uint8_t *restrict out, size_t *restrict pos)
+{
+    offset *= CELL_BYTES;
+    if (offset == 0) {
+        // mod = 00, rm = rbx
+        out[(*pos)++] = 0x03 | (reg << 3);
+    } else if (offset >= -128 && offset <= 127) {
+        // mod = 01, rm = rbx, disp8
+        out[(*pos)++] = 0x43 | (reg << 3);
+        out[(*pos)++] = (uint8_t)offset;
+    } else {
+        // mod = 10, rm = rbx, disp32
+        out[(*pos)++] = 0x83 | (reg << 3);
+        memcpy(out + *pos, &offset, sizeof(int32_t));
+        *pos += sizeof(int32_t);
+    }
+}
+
+// Writes len bytes of the recommended multi-byte nops.
+static void write_nops(size_t len, uint8_t *restrict out, size_t *restrict pos)
+{
+    static const uint8_t nops[9][9] = {
+        { 0x90 },
+        { 0x66, 0x90 },
+        { 0x0f, 0x1f, 0x00 },
+        { 0x0f, 0x1f, 0x40, 0x00 },
+        { 0x0f, 0x1f, 0x44, 0x00, 0x00 },
+        { 0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00 },
+        { 0x0f, 0x1f, 0x80, 0x00, 0x00, 0x00, 0x00 },
+        { 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        { 0x66, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    };
+    if (len > 0) {
+        bf_log("        # %zu bytes of nops\n", len);
+    }
+    while (len > 0) {
+        size_t n = len < 9 ? len : 9;
+        memcpy(out + *pos, nops[n - 1], n);
+        *pos += n;
+        len -= n;
+    }
+}
+
+// add rbx, bytes
+static void write_pointer_add(int32_t bytes, uint8_t *restrict out, size_t *restrict pos)
+{
+    bf_log("        add     " RBX ", %i\n", bytes);
+#ifndef JIT_I386
+    out[(*pos)++] = 0x48;
+#endif
+    if (bytes >= -128 && bytes <= 127) {
+        out[(*pos)++] = 0x83;
+        out[(*pos)++] = 0xc3;
+        out[(*pos)++] = (uint8_t)bytes;
+    } else {
+        out[(*pos)++] = 0x81;
+        out[(*pos)++] = 0xc3;
+        memcpy(out + *pos, &bytes, sizeof(int32_t));
+        *pos += sizeof(int32_t);
+    }
+}
+
+// cmp <cell>, 0
+static void write_cell_test(uint8_t *restrict out, size_t *restrict pos)
+{
+    bf_log("        cmp     " CELL_PTR "[" RBX "], 0\n");
+#if CELL_BITS == 16
+    out[(*pos)++] = 0x66;
+#endif
+    // The wider forms take a sign extended imm8.
+    out[(*pos)++] = CELL_BITS == 8 ? 0x80 : 0x83;
+    out[(*pos)++] = 0x3b;
+    out[(*pos)++] = 0x00;
+}
+
+// Register cache: Cells that are read get a register, and stay there until a loop edge
+// or a scan, so straight-line code doesn't go back to memory for them. Writes go
+// wherever the cell is, and dirty registers are spilled before the edge. Moves just
+// rebase the offsets. The flush and refill stubs save these registers, so '.' and ','
+// don't spill.
+//
+// Each register holds a cell zero extended to 32 bits. Arithmetic is done on the whole
+// register, so only the low CELL_BITS are meaningful.
+#ifdef JIT_I386
+#   define CACHE_REGS 2
+#else
+#   define CACHE_REGS 6
+#endif
+// mov cell, reg with a prefix, REX and disp32
+#define MAX_SPILL_LEN (CACHE_REGS * 8)
+
+typedef struct {
+    // The register number, r8-r11 have bit 3 set.
+    uint8_t reg;
+    bool used;
+    // The register is newer than the cell.
+    bool dirty;
+    // Which cell, relative to rbx.
+    int32_t offset;
+    uint32_t last_use;
+} bf_cached_cell;
+
+// Compiling happens on the pool threads too.
+static bf_thread_local struct {
+    bf_cached_cell regs[CACHE_REGS];
+    uint32_t clock;
+} reg_cache;
+
+// The name of a cache register with the given width, for the logs.
+static inline const char *reg_name(uint8_t reg, int bits)
+{
+    static const char *const names[][3] = {
+        { "al", "ax", "eax" }, { "cl", "cx", "ecx" }, { "dl", "dx", "edx" }, { "bl", "bx", "ebx" },
+        { "spl", "sp", "esp" }, { "bpl", "bp", "ebp" }, { "sil", "si", "esi" }, { "dil", "di", "edi" },
+        { "r8b", "r8w", "r8d" }, { "r9b", "r9w", "r9d" }, { "r10b", "r10w", "r10d" }, { "r11b", "r11w", "r11d" },
+    };
+    return names[reg][bits == 8 ? 0 : bits == 16 ? 1 : 2];
+}
+
+// Writes a REX prefix if reg (in the ModRM reg field) or rm (in the r/m field) is r8-r15.
+static void write_rex(uint8_t reg, uint8_t rm, uint8_t *restrict out, size_t *restrict pos)
+{
+#ifdef JIT_I386
+    (void)reg, (void)rm, (void)out, (void)pos;
+#else
+    if ((reg | rm) & 8) {
+        out[(*pos)++] = 0x40 | ((reg & 8) >> 1) | ((rm & 8) >> 3);
+    }
+#endif
+}
+
+// Writes op reg, reg2 on the 32-bit registers, reg2 in the r/m field.
+static void write_reg_op(uint8_t op, uint8_t reg, uint8_t reg2, uint8_t *restrict out, size_t *restrict pos)
+{
+    write_rex(reg, reg2, out, pos);
+    out[(*pos)++] = op;
+    out[(*pos)++] = 0xc0 | ((reg & 7) << 3) | (reg2 & 7);
+}
+
+// write_cell_opcode() with a REX prefix for reg and rm, for instructions on the low
+// CELL_BITS of registers.
+static void write_cell_reg_opcode(uint8_t byte_op, uint8_t reg, uint8_t rm, uint8_t *restrict out, size_t *restrict pos)
+{
+#if CELL_BITS == 16
+    out[(*pos)++] = 0x66;
+#endif
+    write_rex(reg, rm, out, pos);
+    out[(*pos)++] = CELL_BITS == 8 ? byte_op : byte_op | 1;
+}
+
+// Writes op cell, reg or op reg, cell with the low CELL_BITS of reg, given the byte form
+// of op like write_cell_opcode().
+static void write_cell_reg_insn(uint8_t byte_op, uint8_t reg, int32_t offset, uint8_t *restrict out, size_t *restrict pos)
+{
+    write_cell_reg_opcode(byte_op, reg, 0, out, pos);
+    write_cell_operand(reg & 7, offset, out, pos);
+}
+
+// Forgets everything, at the start of the code and after loop edges.
+static void reset_reg_cache(void)
+{
+#ifdef JIT_I386
+    static const uint8_t regs[CACHE_REGS] = { 1, 2 }; // ecx, edx
+#else
+    static const uint8_t regs[CACHE_REGS] = { 1, 2, 8, 9, 10, 11 }; // ecx, edx, r8d-r11d
+#endif
+    for (size_t i = 0; i < CACHE_REGS; i++) {
+        reg_cache.regs[i].reg = regs[i];
+        reg_cache.regs[i].used = false;
+        reg_cache.regs[i].dirty = false;
+    }
+    reg_cache.clock = 0;
+}
+
+// Returns the register holding the cell at offset, or NULL.
+static bf_cached_cell *find_cached_cell(int32_t offset)
+{
+    for (size_t i = 0; i < CACHE_REGS; i++) {
+        if (reg_cache.regs[i].used && reg_cache.regs[i].offset == offset) {
+            reg_cache.regs[i].last_use = ++reg_cache.clock;
+            return &reg_cache.regs[i];
+        }
+    }
+    return NULL;
+}
+
+// Writes a dirty register back to its cell.
+static void spill_cell(bf_cached_cell *cached, uint8_t *restrict out, size_t *restrict pos)
+{
+    if (!cached->used || !cached->dirty) {
+        return;
+    }
+    bf_log("        mov     " CELL_PTR "[" RBX "%+d], %s\n", cached->offset * CELL_BYTES, reg_name(cached->reg, CELL_BITS));
+    write_cell_reg_insn(0x88, cached->reg, cached->offset, out, pos);
+    cached->dirty = false;
+}
+
+// Spills every dirty register, so memory is up to date. The registers stay valid.
+static void spill_reg_cache(uint8_t *restrict out, size_t *restrict pos)
+{
+    for (size_t i = 0; i < CACHE_REGS; i++) {
+        spill_cell(&reg_cache.regs[i], out, pos);
+    }
+}
+
+// Returns a register for the cell at offset, loading it if load is set. If they are all
+// taken, the least recently used one is spilled.
+static bf_cached_cell *cache_cell(int32_t offset, bool load, uint8_t *restrict out, size_t *restrict pos)
+{
+    bf_cached_cell *cached = find_cached_cell(offset);
+    if (cached != NULL) {
+        return cached;
+    }
+    cached = &reg_cache.regs[0];
+    for (size_t i = 0; i < CACHE_REGS; i++) {
+        if (!reg_cache.regs[i].used) {
+            cached = &reg_cache.regs[i];
+            break;
+        }
+        if (reg_cache.regs[i].last_use < cached->last_use) {
+            cached = &reg_cache.regs[i];
+        }
+    }
+    spill_cell(cached, out, pos);
+    cached->used = true;
+    cached->dirty = false;
+    cached->offset = offset;
+    cached->last_use = ++reg_cache.clock;
+    if (load) {
+        bf_log("        %s   %s, " CELL_PTR "[" RBX "%+d]\n", CELL_BITS == 32 ? "mov  " : "movzx", reg_name(cached->reg, 32), offset * CELL_BYTES);
+        write_rex(cached->reg, 0, out, pos);
+#if CELL_BITS == 32
+        out[(*pos)++] = 0x8b;
+#else
+        out[(*pos)++] = 0x0f;
+        out[(*pos)++] = CELL_BITS == 8 ? 0xb6 : 0xb7;
+#endif
+        write_cell_operand(cached->reg & 7, offset, out, pos);
+    }
+    return cached;
+}
+
+// test reg, reg on the low CELL_BITS of a cached cell.
+static void write_cached_test(const bf_cached_cell *cached, uint8_t *restrict out, size_t *restrict pos)
+{
+    bf_log("        test    %s, %s\n", reg_name(cached->reg, CELL_BITS), reg_name(cached->reg, CELL_BITS));
+    write_cell_reg_opcode(0x84, cached->reg, cached->reg, out, pos);
+    out[(*pos)++] = 0xc0 | ((cached->reg & 7) << 3) | (cached->reg & 7);
+}
+
+// The test at either end of a loop: Spills the cache, compares the current cell to
+// zero, and leaves the cache empty for whatever comes after the jump. The spills are
+// movs, so if the last add or clear was on the current cell, its flags still hold.
+static void write_loop_test(uint8_t *restrict out, size_t *restrict pos)
+{
+    bf_cached_cell *cached = find_cached_cell(0);
+    spill_reg_cache(out, pos);
+    if (zero_flag.valid && zero_flag.offset == 0) {
+        bf_log("        # zero flag is still set from " CELL_PTR "[" RBX "]\n");
+    } else if (cached != NULL) {
+        write_cached_test(cached, out, pos);
+    } else {
+        write_cell_test(out, pos);
+    }
+    reset_reg_cache();
+    // Both ways out of the jump, it is.
+    zero_flag.valid = true;
+    zero_flag.offset = 0;
 }
 
 static inline uint8_t log_2(int32_t val) {
@@ -146,75 +825,529 @@ static inline uint8_t log_2(int32_t val) {
     }
 }
 
-static inline void do_multiply(int32_t op, uint8_t *restrict out, size_t *restrict pos)
+static inline void do_multiply(int32_t op, int32_t base, uint8_t *restrict out, size_t *restrict pos)
 {
-    int32_t offset = op >> 8;
-    int32_t amount = (int8_t)op; // sign extend
-
-    // Store the current cell in al
-    bf_log("        mov     al, byte ptr[" RBX "]\n");
-    out[(*pos)++] = 0x8a;
-    out[(*pos)++] = 0x03;
-
-    switch (amount) {
-    // 1 and 2 are special cases.
-    case 1:
-    case -1:
-        // don't modify al
-        break;
-    case -2:
-    case 2:
-        // shorter to add to itself
-        bf_log("        add      al, al\n");
-        out[(*pos)++] = 0x00;
-        out[(*pos)++] = 0xc0;
-        break;
-    default: {
-        // Either do a shift left with log2(amount), or do an imul.
+    int32_t offset = base + copy_mul_target(op);
+    int32_t amount = copy_mul_factor(op);
+
+    // The source cell is read by every copy in the loop, so keep it in a register.
+    uint8_t reg = cache_cell(base, true, out, pos)->reg;
+
+    if (amount != 1 && amount != -1) {
+        // Multiply a copy of it in eax. Only the low bits matter, so the 32-bit forms
+        // are right for every cell width.
+        bf_log("        mov     eax, %s\n", reg_name(reg, 32));
+        write_reg_op(0x89, reg, 0, out, pos);
+        reg = 0;
         uint8_t shift = log_2(amount);
-        if (shift) {
-            // Shift left
-            bf_log("        shl    al, %d\n", shift);
+        if (amount == 2 || amount == -2) {
+            // shorter to add to itself
+            bf_log("        add     eax, eax\n");
+            out[(*pos)++] = 0x01;
             out[(*pos)++] = 0xc0;
+        } else if (shift) {
+            // Shift left
+            bf_log("        shl     eax, %d\n", shift);
+            out[(*pos)++] = 0xc1;
             out[(*pos)++] = 0xe0;
             out[(*pos)++] = shift;
         } else {
-            // Get our multiple
-            bf_log("        mov    cl, %u\n", amount);
-            out[(*pos)++] = 0xb1;
-            out[(*pos)++] = abs(amount);
-            // AX = AL * CL, discard upper bits
-            bf_log("        imul   cl\n");
-            out[(*pos)++] = 0xf6;
-            out[(*pos)++] = 0xe9;
-        }
+            bf_log("        imul    eax, eax, %d\n", abs(amount));
+            out[(*pos)++] = 0x69;
+            out[(*pos)++] = 0xc0;
+            int32_t factor = abs(amount);
+            memcpy(out + *pos, &factor, sizeof(int32_t));
+            *pos += sizeof(int32_t);
         }
-        break;
     }
     // multiply by negative - DRY: only the first byte differs between add and sub
-    if (amount < 0) {
-        bf_log("        sub     byte ptr[" RBX "%+d], al\n", offset);
-        out[(*pos)++] = 0x28;
+    bf_cached_cell *target = find_cached_cell(offset);
+    if (target != NULL) {
+        bf_log("        %s     %s, %s\n", amount < 0 ? "sub" : "add", reg_name(target->reg, CELL_BITS), reg_name(reg, CELL_BITS));
+        write_cell_reg_opcode(amount < 0 ? 0x28 : 0x00, reg, target->reg, out, pos);
+        out[(*pos)++] = 0xc0 | ((reg & 7) << 3) | (target->reg & 7);
+        target->dirty = true;
     } else {
-        bf_log("        add     byte ptr[" RBX "%+d], al\n", offset);
-        out[(*pos)++] = 0x00;
+        bf_log("        %s     " CELL_PTR "[" RBX "%+d], %s\n", amount < 0 ? "sub" : "add", offset * CELL_BYTES, reg_name(reg, CELL_BITS));
+        write_cell_reg_insn(amount < 0 ? 0x28 : 0x00, reg, offset, out, pos);
+    }
+    zero_flag.valid = true;
+    zero_flag.offset = offset;
+}
+
+// Scans for a zero cell stride cells at a time, e.g. [>] or [<<].
+//
+// On x86_64, strides that divide the vector width check a whole vector of cells at a
+// time with pcmpeqb (or pcmpeqw/pcmpeqd for wider cells) and pick the matching cells out
+// of the pmovmskb mask. The tape is padded so the loads can run off either end. Anything
+// else is a plain loop.
+static void write_scan(int32_t stride, uint8_t *restrict out, size_t *restrict pos)
+{
+    size_t done_jump, loop;
+
+    if (!zero_flag.valid || zero_flag.offset != 0) {
+        write_cell_test(out, pos);
     }
+    zero_flag.valid = false;
+    bf_log("        je      .Ldone\n");
+    out[(*pos)++] = 0x74;
+    done_jump = (*pos)++;
+
+#ifndef JIT_I386
+    bool avx2 = (jit_cpu_features() & JIT_CPU_AVX2) != 0;
+    int32_t width = avx2 ? 32 : 16;
+    // In bytes
+    int32_t step = (stride < 0 ? -stride : stride) * CELL_BYTES;
+    if (step < width && width % step == 0) {
+        // The cells we look at in each vector. Going backwards, that is the top byte of
+        // each cell, so bsr lands on the same spot for any cell width.
+        uint32_t mask = 0;
+        for (int32_t i = 0; i < width; i += step) {
+            mask |= 1u << (stride > 0 ? i : width - 1 - i);
+        }
+        if (avx2) {
+            bf_log("        vpxor   ymm0, ymm0, ymm0\n");
+            out[(*pos)++] = 0xc5;
+            out[(*pos)++] = 0xfd;
+        } else {
+            bf_log("        pxor    xmm0, xmm0\n");
+            out[(*pos)++] = 0x66;
+            out[(*pos)++] = 0x0f;
+        }
+        out[(*pos)++] = 0xef;
+        out[(*pos)++] = 0xc0;
+
+        loop = *pos;
+        // Going backwards, we load the vector that ends at rbx's cell.
+        if (avx2) {
+            bf_log("        vmovdqu ymm1, ymmword ptr[rbx - %d]\n", stride > 0 ? 0 : width - CELL_BYTES);
+            out[(*pos)++] = 0xc5;
+            out[(*pos)++] = 0xfe;
+        } else {
+            bf_log("        movdqu  xmm1, xmmword ptr[rbx - %d]\n", stride > 0 ? 0 : width - CELL_BYTES);
+            out[(*pos)++] = 0xf3;
+            out[(*pos)++] = 0x0f;
+        }
+        out[(*pos)++] = 0x6f;
+        if (stride > 0) {
+            out[(*pos)++] = 0x0b;
+        } else {
+            out[(*pos)++] = 0x4b;
+            out[(*pos)++] = (uint8_t)(CELL_BYTES - width);
+        }
+
+        if (avx2) {
+            bf_log("        vpcmpeq" CELL_SUFFIX " ymm1, ymm1, ymm0\n");
+            out[(*pos)++] = 0xc5;
+            out[(*pos)++] = 0xf5;
+        } else {
+            bf_log("        pcmpeq" CELL_SUFFIX " xmm1, xmm0\n");
+            out[(*pos)++] = 0x66;
+            out[(*pos)++] = 0x0f;
+        }
+        out[(*pos)++] = CELL_PCMPEQ;
+        out[(*pos)++] = 0xc8;
+
+        if (avx2) {
+            bf_log("        vpmovmskb eax, ymm1\n");
+            out[(*pos)++] = 0xc5;
+            out[(*pos)++] = 0xfd;
+        } else {
+            bf_log("        pmovmskb eax, xmm1\n");
+            out[(*pos)++] = 0x66;
+            out[(*pos)++] = 0x0f;
+        }
+        out[(*pos)++] = 0xd7;
+        out[(*pos)++] = 0xc1;
+
+        if (step == CELL_BYTES) {
+            bf_log("        test    eax, eax\n");
+            out[(*pos)++] = 0x85;
+            out[(*pos)++] = 0xc0;
+        } else {
+            bf_log("        and     eax, 0x%x\n", mask);
+            out[(*pos)++] = 0x25;
+            memcpy(out + *pos, &mask, sizeof(uint32_t));
+            *pos += sizeof(uint32_t);
+        }
+        bf_log("        jnz     .Lfound\n");
+        out[(*pos)++] = 0x75;
+        out[(*pos)++] = 0x06;
+
+        bf_log("        %s     rbx, %d\n", stride > 0 ? "add" : "sub", width);
+        out[(*pos)++] = 0x48;
+        out[(*pos)++] = 0x83;
+        out[(*pos)++] = stride > 0 ? 0xc3 : 0xeb;
+        out[(*pos)++] = (uint8_t)width;
+
+        bf_log("        jmp     .Lloop\n");
+        out[(*pos)++] = 0xeb;
+        out[*pos] = (uint8_t)(loop - (*pos + 1));
+        ++*pos;
+
+        // .Lfound: the first match forwards is the lowest bit, backwards the highest.
+        if (stride > 0) {
+            bf_log("        bsf     eax, eax\n");
+            out[(*pos)++] = 0x0f;
+            out[(*pos)++] = 0xbc;
+            out[(*pos)++] = 0xc0;
+            bf_log("        add     rbx, rax\n");
+            out[(*pos)++] = 0x48;
+            out[(*pos)++] = 0x01;
+            out[(*pos)++] = 0xc3;
+        } else {
+            bf_log("        bsr     eax, eax\n");
+            out[(*pos)++] = 0x0f;
+            out[(*pos)++] = 0xbd;
+            out[(*pos)++] = 0xc0;
+            bf_log("        lea     rbx, [rbx + rax - %d]\n", width - 1);
+            out[(*pos)++] = 0x48;
+            out[(*pos)++] = 0x8d;
+            out[(*pos)++] = 0x5c;
+            out[(*pos)++] = 0x03;
+            out[(*pos)++] = (uint8_t)(1 - width);
+        }
+        if (avx2) {
+            bf_log("        vzeroupper\n");
+            out[(*pos)++] = 0xc5;
+            out[(*pos)++] = 0xf8;
+            out[(*pos)++] = 0x77;
+        }
+        out[done_jump] = (uint8_t)(*pos - (done_jump + 1));
+        return;
+    }
+#endif // !JIT_I386
+
+    loop = *pos;
+    write_pointer_add(stride * CELL_BYTES, out, pos);
+    write_cell_test(out, pos);
+    bf_log("        jne     .Lloop\n");
+    out[(*pos)++] = 0x75;
+    out[*pos] = (uint8_t)(loop - (*pos + 1));
+    ++*pos;
+    out[done_jump] = (uint8_t)(*pos - (done_jump + 1));
+}
+
+// Checked builds: Calls io->tape_error unless cells lo to hi are within io->tape_start
+// and io->tape_end. The output pointer is synced first so it can flush.
+static void write_check(int32_t lo, int32_t hi, uint8_t *restrict out, size_t *restrict pos)
+{
+    // analyze_tape() keeps these small enough to scale.
+    lo *= CELL_BYTES;
+    hi *= CELL_BYTES;
+#ifdef JIT_I386
+    bf_log("        lea     eax, [ebx%+d]\n", lo);
+    out[(*pos)++] = 0x8d;
+    out[(*pos)++] = 0x83;
+    memcpy(out + *pos, &lo, sizeof(int32_t));
+    *pos += sizeof(int32_t);
+    bf_log("        cmp     eax, dword ptr[edi + 32]\n");
+    out[(*pos)++] = 0x3b;
+    out[(*pos)++] = 0x47;
+    out[(*pos)++] = 0x20;
+    bf_log("        jb      .Lout_of_bounds\n");
+    out[(*pos)++] = 0x72;
+    out[(*pos)++] = 0x0b;
+    bf_log("        lea     eax, [ebx%+d]\n", hi);
+    out[(*pos)++] = 0x8d;
+    out[(*pos)++] = 0x83;
+    memcpy(out + *pos, &hi, sizeof(int32_t));
+    *pos += sizeof(int32_t);
+    bf_log("        cmp     eax, dword ptr[edi + 36]\n");
+    out[(*pos)++] = 0x3b;
+    out[(*pos)++] = 0x47;
+    out[(*pos)++] = 0x24;
+    bf_log("        jb      .Lin_bounds\n");
+    out[(*pos)++] = 0x72;
+    out[(*pos)++] = 0x06;
+    bf_log(".Lout_of_bounds:\n");
+    bf_log("        mov     dword ptr[edi], esi\n");
+    out[(*pos)++] = 0x89;
+    out[(*pos)++] = 0x37;
+    bf_log("        push    edi\n");
+    out[(*pos)++] = 0x57;
+    bf_log("        call    dword ptr[edi + 40]\n");
+    out[(*pos)++] = 0xff;
+    out[(*pos)++] = 0x57;
+    out[(*pos)++] = 0x28;
+#else
+    bf_log("        lea     rax, [rbx%+d]\n", lo);
+    out[(*pos)++] = 0x48;
+    out[(*pos)++] = 0x8d;
+    out[(*pos)++] = 0x83;
+    memcpy(out + *pos, &lo, sizeof(int32_t));
+    *pos += sizeof(int32_t);
+    bf_log("        cmp     rax, qword ptr[r12 + 64]\n");
+    out[(*pos)++] = 0x49;
+    out[(*pos)++] = 0x3b;
+    out[(*pos)++] = 0x44;
+    out[(*pos)++] = 0x24;
+    out[(*pos)++] = 0x40;
+    bf_log("        jb      .Lout_of_bounds\n");
+    out[(*pos)++] = 0x72;
+    out[(*pos)++] = 0x0e;
+    bf_log("        lea     rax, [rbx%+d]\n", hi);
+    out[(*pos)++] = 0x48;
+    out[(*pos)++] = 0x8d;
     out[(*pos)++] = 0x83;
-    // add offset
-    memcpy(out + *pos, &offset, sizeof(int32_t));
+    memcpy(out + *pos, &hi, sizeof(int32_t));
     *pos += sizeof(int32_t);
+    bf_log("        cmp     rax, qword ptr[r12 + 72]\n");
+    out[(*pos)++] = 0x49;
+    out[(*pos)++] = 0x3b;
+    out[(*pos)++] = 0x44;
+    out[(*pos)++] = 0x24;
+    out[(*pos)++] = 0x48;
+    bf_log("        jb      .Lin_bounds\n");
+    out[(*pos)++] = 0x72;
+#ifdef _WIN32
+    out[(*pos)++] = 0x10;
+#else
+    out[(*pos)++] = 0x0c;
+#endif
+    bf_log(".Lout_of_bounds:\n");
+    bf_log("        mov     qword ptr[r12], r13\n");
+    out[(*pos)++] = 0x4d;
+    out[(*pos)++] = 0x89;
+    out[(*pos)++] = 0x2c;
+    out[(*pos)++] = 0x24;
+    // The stack is aligned in the body, it doesn't return.
+#ifdef _WIN32
+    bf_log("        sub     rsp, 32\n");
+    out[(*pos)++] = 0x48;
+    out[(*pos)++] = 0x83;
+    out[(*pos)++] = 0xec;
+    out[(*pos)++] = 0x20;
+    bf_log("        mov     rcx, r12\n");
+    out[(*pos)++] = 0x4c;
+    out[(*pos)++] = 0x89;
+    out[(*pos)++] = 0xe1;
+#else
+    bf_log("        mov     rdi, r12\n");
+    out[(*pos)++] = 0x4c;
+    out[(*pos)++] = 0x89;
+    out[(*pos)++] = 0xe7;
+#endif
+    bf_log("        call    qword ptr[r12 + 80]\n");
+    out[(*pos)++] = 0x41;
+    out[(*pos)++] = 0xff;
+    out[(*pos)++] = 0x54;
+    out[(*pos)++] = 0x24;
+    out[(*pos)++] = 0x50;
+#endif
+    bf_log(".Lin_bounds:\n");
 }
 
+#ifdef LAZY
+// -DLAZY: The stub standing in for a top-level loop. Unless the current cell is zero, it
+// hands the I/O pointers back to io and calls *slot(cells, io, index), which runs the
+// whole loop and returns the pointer. The cache registers are caller saved, so they
+// are spilled and forgotten like at any loop edge.
+static void write_lazy_call(void *const *slot, uint32_t index, uint8_t *restrict out, size_t *restrict pos)
+{
+    write_loop_test(out, pos);
+#ifdef JIT_I386
+    uint8_t call[] = {
+        // je .Lskip
+        0x74, 0x00,
+        // mov dword ptr[edi], esi
+        0x89, 0x37,
+        // mov dword ptr[edi + 8], ebp
+        0x89, 0x6f, 0x08,
+        // push index
+        0x68, 0x00, 0x00, 0x00, 0x00,
+        // push edi
+        0x57,
+        // push ebx
+        0x53,
+        // mov eax, slot
+        0xb8, 0x00, 0x00, 0x00, 0x00,
+        // call dword ptr[eax]
+        0xff, 0x10,
+        // add esp, 12
+        0x83, 0xc4, 0x0c,
+        // mov ebx, eax
+        0x89, 0xc3,
+        // mov esi, dword ptr[edi]
+        0x8b, 0x37,
+        // mov ebp, dword ptr[edi + 8]
+        0x8b, 0x6f, 0x08,
+        // .Lskip:
+    };
+    const size_t index_pos = 8, slot_pos = 15;
+    uint32_t addr = (uint32_t)(uintptr_t)slot;
+    bf_log(
+        "        je      .Lskip\n"
+        "        mov     dword ptr[edi], esi\n"
+        "        mov     dword ptr[edi + 8], ebp\n"
+        "        push    %u\n"
+        "        push    edi\n"
+        "        push    ebx\n"
+        "        mov     eax, %p\n"
+        "        call    dword ptr[eax]\n"
+        "        add     esp, 12\n"
+        "        mov     ebx, eax\n"
+        "        mov     esi, dword ptr[edi]\n"
+        "        mov     ebp, dword ptr[edi + 8]\n"
+        ".Lskip:\n", index, (const void *)slot
+    );
+#else
+    uint8_t call[] = {
+        // je .Lskip
+        0x74, 0x00,
+        // mov qword ptr[r12], r13
+        0x4d, 0x89, 0x2c, 0x24,
+        // mov qword ptr[r12 + 16], r15
+        0x4d, 0x89, 0x7c, 0x24, 0x10,
+#ifdef _WIN32
+        // sub rsp, 32
+        0x48, 0x83, 0xec, 0x20,
+        // mov rcx, rbx
+        0x48, 0x89, 0xd9,
+        // mov rdx, r12
+        0x4c, 0x89, 0xe2,
+        // mov r8d, index
+        0x41, 0xb8, 0x00, 0x00, 0x00, 0x00,
+#else
+        // mov rdi, rbx
+        0x48, 0x89, 0xdf,
+        // mov rsi, r12
+        0x4c, 0x89, 0xe6,
+        // mov edx, index
+        0xba, 0x00, 0x00, 0x00, 0x00,
+#endif
+        // mov rax, slot
+        0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        // call qword ptr[rax]
+        0xff, 0x10,
+#ifdef _WIN32
+        // add rsp, 32
+        0x48, 0x83, 0xc4, 0x20,
+#endif
+        // mov rbx, rax
+        0x48, 0x89, 0xc3,
+        // mov r13, qword ptr[r12]
+        0x4d, 0x8b, 0x2c, 0x24,
+        // mov r15, qword ptr[r12 + 16]
+        0x4d, 0x8b, 0x7c, 0x24, 0x10,
+        // .Lskip:
+    };
+#ifdef _WIN32
+    const size_t index_pos = 23, slot_pos = 29;
+#else
+    const size_t index_pos = 18, slot_pos = 24;
+#endif
+    uint64_t addr = (uint64_t)(uintptr_t)slot;
+    bf_log(
+        "        je      .Lskip\n"
+        "        mov     qword ptr[r12], r13\n"
+        "        mov     qword ptr[r12 + 16], r15\n"
+#ifdef _WIN32
+        "        sub     rsp, 32\n"
+        "        mov     rcx, rbx\n"
+        "        mov     rdx, r12\n"
+        "        mov     r8d, %u\n"
+#else
+        "        mov     rdi, rbx\n"
+        "        mov     rsi, r12\n"
+        "        mov     edx, %u\n"
+#endif
+        "        mov     rax, %p\n"
+        "        call    qword ptr[rax]\n"
+#ifdef _WIN32
+        "        add     rsp, 32\n"
+#endif
+        "        mov     rbx, rax\n"
+        "        mov     r13, qword ptr[r12]\n"
+        "        mov     r15, qword ptr[r12 + 16]\n"
+        ".Lskip:\n", index, (const void *)slot
+    );
+#endif
+    call[1] = (uint8_t)(sizeof(call) - 2);
+    memcpy(&call[index_pos], &index, sizeof(index));
+    memcpy(&call[slot_pos], &addr, sizeof(addr));
+    memcpy(out + *pos, call, sizeof(call));
+    *pos += sizeof(call);
+    // The call clobbers the flags.
+    zero_flag.valid = false;
+}
+#endif
+
+#ifdef PROFILE
+// -DPROFILE: Adds one to io->profile_counts[site]. Only eax and the flags change, so the
+// cache stays.
+static void write_profile_count(uint32_t site, uint8_t *restrict out, size_t *restrict pos)
+{
+    int32_t counts = (int32_t)offsetof(bf_io, profile_counts);
+    int32_t disp = (int32_t)(site * sizeof(uint64_t));
+#ifdef JIT_I386
+    bf_log("        mov     eax, dword ptr[edi + %d]\n", counts);
+    out[(*pos)++] = 0x8b;
+    out[(*pos)++] = 0x87;
+    memcpy(out + *pos, &counts, sizeof(int32_t));
+    *pos += sizeof(int32_t);
+    bf_log("        add     dword ptr[eax + %d], 1\n", disp);
+    out[(*pos)++] = 0x83;
+    out[(*pos)++] = 0x80;
+    memcpy(out + *pos, &disp, sizeof(int32_t));
+    *pos += sizeof(int32_t);
+    out[(*pos)++] = 0x01;
+    disp += 4;
+    bf_log("        adc     dword ptr[eax + %d], 0\n", disp);
+    out[(*pos)++] = 0x83;
+    out[(*pos)++] = 0x90;
+    memcpy(out + *pos, &disp, sizeof(int32_t));
+    *pos += sizeof(int32_t);
+    out[(*pos)++] = 0x00;
+#else
+    bf_log("        mov     rax, qword ptr[r12 + %d]\n", counts);
+    out[(*pos)++] = 0x49;
+    out[(*pos)++] = 0x8b;
+    out[(*pos)++] = 0x84;
+    out[(*pos)++] = 0x24;
+    memcpy(out + *pos, &counts, sizeof(int32_t));
+    *pos += sizeof(int32_t);
+    bf_log("        inc     qword ptr[rax + %d]\n", disp);
+    out[(*pos)++] = 0x48;
+    out[(*pos)++] = 0xff;
+    out[(*pos)++] = 0x80;
+    memcpy(out + *pos, &disp, sizeof(int32_t));
+    *pos += sizeof(int32_t);
+#endif
+    zero_flag.valid = false;
+}
+#endif
+
 /// Compiles a single opcode.
 static void compile_opcode(bf_opcode *restrict opcode, uint8_t *restrict out, size_t *restrict pos)
 {
+#ifdef PROFILE
+    // Loops count at the top of their body, the ones we turned into something else
+    // count here.
+    if (opcode->site != 0 && opcode->op != bf_opcode_start) {
+        write_profile_count(opcode->site - 1, out, pos);
+    }
+#endif
     if (opcode->op == bf_opcode_nop)
         return;
     switch (opcode->op) {
     case bf_opcode_move:
         if (opcode->amount == 0)
             return;
-        if (opcode->amount == 1) {
+        // The cached cells stay where they are, so they move the other way.
+        for (size_t i = 0; i < CACHE_REGS; i++) {
+            reg_cache.regs[i].offset -= opcode->amount;
+        }
+        if (zero_flag.valid) {
+            // lea leaves the flags alone, so a loop test after this can still use them.
+            zero_flag.offset -= opcode->amount;
+            bf_log("        lea     " RBX ", [" RBX "%+d]\n", opcode->amount * CELL_BYTES);
+#ifndef JIT_I386
+            out[(*pos)++] = 0x48;
+#endif
+            out[(*pos)++] = 0x8d;
+            write_cell_operand(3, opcode->amount, out, pos);
+        } else if (opcode->amount == 1 && CELL_BYTES == 1) {
             bf_log("        inc     " RBX "\n");
 #ifndef JIT_I386
             // skip REX.W byte on x86
@@ -222,7 +1355,7 @@ static void compile_opcode(bf_opcode *restrict opcode, uint8_t *restrict out, si
 #endif
             out[(*pos)++] = 0xff;
             out[(*pos)++] = 0xc3;
-        } else if (opcode->amount == -1) {
+        } else if (opcode->amount == -1 && CELL_BYTES == 1) {
             bf_log("        dec     " RBX "\n");
 #ifndef JIT_I386
             out[(*pos)++] = 0x48;
@@ -231,142 +1364,283 @@ static void compile_opcode(bf_opcode *restrict opcode, uint8_t *restrict out, si
             out[(*pos)++] = 0xcb;
         } else {
             // overflow with sign extension on negative
-            bf_log("        add     " RBX ", %i\n", opcode->amount);
-#ifndef JIT_I386
-            out[(*pos)++] = 0x48;
-#endif
-            out[(*pos)++] = 0x81;
-            out[(*pos)++] = 0xc3;
-            memcpy(out + *pos, &opcode->amount, sizeof(int32_t));
-            *pos += sizeof(int32_t);
+            write_pointer_add(opcode->amount * CELL_BYTES, out, pos);
         }
         return;
-    case bf_opcode_add: // Add / subtract
+    case bf_opcode_add: { // Add / subtract
         if (opcode->amount == 0)
             return;
 
-        if (opcode->amount == 1) {
-            bf_log("        inc     byte ptr[" RBX "]\n");
-            out[(*pos)++] = 0xfe;
-            out[(*pos)++] = 0x03;
+        bf_cached_cell *cached = find_cached_cell(opcode->offset);
+        // Whichever way it is done, it is done at the cell width so the zero flag
+        // matches the cell.
+        zero_flag.valid = true;
+        zero_flag.offset = opcode->offset;
+        if (cached != NULL) {
+            uint8_t reg = cached->reg;
+            cached->dirty = true;
+            if (opcode->amount == 1 || opcode->amount == -1) {
+                bf_log("        %s     %s\n", opcode->amount == 1 ? "inc" : "dec", reg_name(reg, CELL_BITS));
+                write_cell_reg_opcode(0xfe, 0, reg, out, pos);
+                out[(*pos)++] = (opcode->amount == 1 ? 0xc0 : 0xc8) | (reg & 7);
+            } else {
+                int32_t amount = CELL_BITS == 8 ? (int8_t)opcode->amount
+                               : CELL_BITS == 16 ? (int16_t)opcode->amount
+                               : opcode->amount;
+                bool imm8 = amount >= -128 && amount <= 127;
+                bf_log("        add     %s, %i\n", reg_name(reg, CELL_BITS), amount);
+#if CELL_BITS == 16
+                out[(*pos)++] = 0x66;
+#endif
+                write_rex(0, reg, out, pos);
+                out[(*pos)++] = CELL_BITS == 8 ? 0x80 : imm8 ? 0x83 : 0x81;
+                out[(*pos)++] = 0xc0 | (reg & 7);
+                if (imm8) {
+                    out[(*pos)++] = (uint8_t)amount;
+                } else {
+                    write_cell_imm(amount, out, pos);
+                }
+            }
+        } else if (opcode->amount == 1) {
+            bf_log("        inc     " CELL_PTR "[" RBX "%+d]\n", opcode->offset * CELL_BYTES);
+            write_cell_opcode(0xfe, out, pos);
+            write_cell_operand(0, opcode->offset, out, pos);
         } else if (opcode->amount == -1) {
-            bf_log("        dec     byte ptr[" RBX "]\n");
-            out[(*pos)++] = 0xfe;
-            out[(*pos)++] = 0x0b;
-        } else {
+            bf_log("        dec     " CELL_PTR "[" RBX "%+d]\n", opcode->offset * CELL_BYTES);
+            write_cell_opcode(0xfe, out, pos);
+            write_cell_operand(1, opcode->offset, out, pos);
+        } else if (CELL_BITS == 8) {
             // overflow with the sign extension on negative
-            bf_log("        add     byte ptr[" RBX "], %i\n", opcode->amount & 0xFF);
+            bf_log("        add     byte ptr[" RBX "%+d], %i\n", opcode->offset, opcode->amount & 0xFF);
             out[(*pos)++] = 0x80;
-            out[(*pos)++] = 0x03;
+            write_cell_operand(0, opcode->offset, out, pos);
             out[(*pos)++] = opcode->amount & 0xFF;
+        } else {
+            // Wrap it to the cell width, and use a sign extended imm8 if it fits.
+            int32_t amount = CELL_BITS == 16 ? (int16_t)opcode->amount : opcode->amount;
+            bool imm8 = amount >= -128 && amount <= 127;
+            bf_log("        add     " CELL_PTR "[" RBX "%+d], %i\n", opcode->offset * CELL_BYTES, amount);
+#if CELL_BITS == 16
+            out[(*pos)++] = 0x66;
+#endif
+            out[(*pos)++] = imm8 ? 0x83 : 0x81;
+            write_cell_operand(0, opcode->offset, out, pos);
+            if (imm8) {
+                out[(*pos)++] = (uint8_t)amount;
+            } else {
+                write_cell_imm(amount, out, pos);
+            }
         }
         return;
-    case bf_opcode_start: // Opening brace
-        bf_log("        cmp     byte ptr[" RBX "], 0\n");
-        out[(*pos)++] = 0x80;
-        out[(*pos)++] = 0x3b;
-        out[(*pos)++] = 0x00;
+    }
+    case bf_opcode_start: { // Opening brace
+        write_loop_test(out, pos);
+
+        // The body starts after the 6 byte je.
+        size_t pad = loop_padding(opcode, *pos + 6);
 
         bf_log("        je      <tbd>\n");
         out[(*pos)++] = 0x0f;
         out[(*pos)++] = 0x84;
 
-        // Dynamic programming: store the offset for bf_opcode_end
+        // Dynamic programming: store the offset for bf_opcode_end, and how much padding
+        // there is before the body.
         opcode->amount = (int32_t)(*pos);
+        opcode->offset = (int32_t)pad;
 
         *pos += 4; // placeholder, we insert the address later.
+        if (pad != 0) {
+            write_nops(pad, out, pos);
+            recent_calls.aligned_body = *pos;
+        }
+#ifdef PROFILE
+        if (opcode->site != 0) {
+            write_profile_count(opcode->site - 1, out, pos);
+        }
+#endif
         return;
+    }
     case bf_opcode_end: { // Closing brace
-        bf_log("        cmp     byte ptr[" RBX "], 0\n");
-        out[(*pos)++] = 0x80;
-        out[(*pos)++] = 0x3b;
-        out[(*pos)++] = 0x00;
+        write_loop_test(out, pos);
 
-        bf_log("        jne     <tbd>\n");
+        // The offset of our start is in start, and it points to the je's rel32.
+        bf_opcode *start = &opcode[opcode->amount];
+        size_t field = (size_t)start->amount;
+        size_t body = field + 4 + (size_t)start->offset;
+        size_t len = *pos - body;
+
+        // How much the body can move back with a short je, and how much padding is left
+        // in front of it.
+        size_t spare = body - field;
+        size_t pad = 0;
+#if LOOP_ALIGN > 1
+        if (recent_calls.aligned_body >= body) {
+            pad = spare % LOOP_ALIGN;
+        }
+#endif
+        size_t shift = spare - pad;
+
+        if (pad + len <= MAX_SHORT_BODY) {
+            // Both jumps fit in rel8. Turn the je into 74 xx and move the body back
+            // into the space that frees up.
+            bf_log("        jne     .Lbody (rel8, je relaxed)\n");
+            memmove(out + field + pad, out + body, len);
+            for (size_t i = 0; i < RECENT_CALLS && i < recent_calls.count; i++) {
+                size_t *call = &recent_calls.pos[(recent_calls.count - 1 - i) % RECENT_CALLS];
+                if (*call >= body) {
+                    // The call moved closer to its stub, which is behind it.
+                    *call -= shift;
+                    int32_t rel;
+                    memcpy(&rel, out + *call, sizeof(int32_t));
+                    rel += (int32_t)shift;
+                    memcpy(out + *call, &rel, sizeof(int32_t));
+                }
+            }
+            if (recent_calls.aligned_body >= body) {
+                recent_calls.aligned_body -= shift;
+            }
+            size_t nop_pos = field;
+            write_nops(pad, out, &nop_pos);
+            *pos -= shift;
+            out[field - 2] = 0x74;
+            out[field - 1] = (uint8_t)(pad + len + 2);
+            out[(*pos)++] = 0x75;
+            out[(*pos)++] = (uint8_t)-(int32_t)(len + 2);
+            return;
+        }
+
+        bf_log("        jne     .Lbody\n");
         out[(*pos)++] = 0x0f;
         out[(*pos)++] = 0x85;
 
-        // Fill in the je and jne. The offset of our start is in start.
-        bf_opcode *start = &opcode[opcode->amount];
-
-        int32_t offset_to = start->amount - *pos;
-        int32_t offset_from = *pos - start->amount;
-        memcpy(out + start->amount, &offset_from, sizeof(int32_t));
+        // Fill in the je and jne.
+        int32_t offset_to = (int32_t)(body - (*pos + 4));
+        int32_t offset_from = (int32_t)(*pos - field);
+        memcpy(out + field, &offset_from, sizeof(int32_t));
         memcpy(out + *pos, &offset_to, sizeof(int32_t));
         *pos += 4;
 
         return;
     }
-    case bf_opcode_put:
+    case bf_opcode_put: {
+        // Append the cell to the output buffer, and flush it if it is full. Only the low
+        // byte of a wider cell goes out.
+        uint8_t reg = cache_cell(opcode->offset, true, out, pos)->reg;
+        zero_flag.valid = false;
 #ifdef JIT_I386
-        // cdecl is beautiful
-        // Set up params
-        bf_log("        movzx   eax, byte ptr[ebx]\n");
-        out[(*pos)++] = 0x0f;
-        out[(*pos)++] = 0xb6;
-        out[(*pos)++] = 0x03;
-        bf_log("        push    eax\n");
-        out[(*pos)++] = 0x50;
-        // Call putchar. It is at esp + 16 + 4 (from the push eax)
-        bf_log("        call    dword ptr[esp + 20]\n");
-        out[(*pos)++] = 0xff;
-        out[(*pos)++] = 0x54;
-        out[(*pos)++] = 0x24;
-        out[(*pos)++] = 0x14;
-        // Clean up the stack
-        bf_log("        add     esp, 4\n");
-        out[(*pos)++] = 0x83;
-        out[(*pos)++] = 0xc4;
-        out[(*pos)++] = 0x04;
-#else // x86_64
-#ifdef _WIN32 // Windows ABI
-        bf_log("        movzx   ecx, byte ptr[rbx]\n"); // zero extend to int
-        out[(*pos)++] = 0x0f;
-        out[(*pos)++] = 0xb6;
-        out[(*pos)++] = 0x0b;
-#else // System V ABI
-        bf_log("        movzx   edi, byte ptr[rbx]\n"); // zero extend to int
-        out[(*pos)++] = 0x0f;
-        out[(*pos)++] = 0xb6;
+        bf_log("        mov     byte ptr[esi], %s\n", reg_name(reg, 8));
+        out[(*pos)++] = 0x88;
+        out[(*pos)++] = 0x06 | (reg << 3);
+        bf_log("        inc     esi\n");
+        out[(*pos)++] = 0x46;
+        bf_log("        cmp     esi, dword ptr[edi + 4]\n");
         out[(*pos)++] = 0x3b;
-#endif
-
-        bf_log("        call    r14\n"); // call putchar (which is in r14)
-        out[(*pos)++] = 0x41;
+        out[(*pos)++] = 0x77;
+        out[(*pos)++] = 0x04;
+#else
+        bf_log("        mov     byte ptr[r13], %s\n", reg_name(reg, 8));
+        write_rex(reg, 13, out, pos);
+        out[(*pos)++] = 0x88;
+        out[(*pos)++] = 0x45 | ((reg & 7) << 3);
+        out[(*pos)++] = 0x00;
+        bf_log("        inc     r13\n");
+        out[(*pos)++] = 0x49;
         out[(*pos)++] = 0xff;
-        out[(*pos)++] = 0xd6;
-#endif // x86_64
+        out[(*pos)++] = 0xc5;
+        bf_log("        cmp     r13, r14\n");
+        out[(*pos)++] = 0x4d;
+        out[(*pos)++] = 0x39;
+        out[(*pos)++] = 0xf5;
+#endif
+        bf_log("        jb      .Lnot_full\n");
+        out[(*pos)++] = 0x72;
+        out[(*pos)++] = 0x05;
+        write_flush_call(out, pos);
         return;
-    case bf_opcode_get: // Calls getchar (r12/stack), and then stores the result in the address of rbx.
+    }
+    case bf_opcode_get:
+        // Take the next byte from the input buffer, and refill it if it is empty.
+        zero_flag.valid = false;
 #ifdef JIT_I386
-        bf_log("        call    dword ptr[esp + 20]\n");
-        out[(*pos)++] = 0xff;
-        out[(*pos)++] = 0x54;
+        bf_log("        cmp     ebp, dword ptr[edi + 12]\n");
+        out[(*pos)++] = 0x3b;
+        out[(*pos)++] = 0x6f;
+        out[(*pos)++] = 0x0c;
+#else
+        bf_log("        cmp     r15, qword ptr[r12 + 24]\n");
+        out[(*pos)++] = 0x4d;
+        out[(*pos)++] = 0x3b;
+        out[(*pos)++] = 0x7c;
         out[(*pos)++] = 0x24;
-        out[(*pos)++] = 0x14;
+        out[(*pos)++] = 0x18;
+#endif
+        bf_log("        jb      .Lhave_input\n");
+        out[(*pos)++] = 0x72;
+        out[(*pos)++] = 0x05;
+        write_refill_call(out, pos);
+        {
+            // The byte goes straight into the cell's register, zero extended.
+            bf_cached_cell *cached = cache_cell(opcode->offset, false, out, pos);
+            uint8_t reg = cached->reg;
+            cached->dirty = true;
+#ifdef JIT_I386
+            bf_log("        movzx   %s, byte ptr[ebp]\n", reg_name(reg, 32));
+            out[(*pos)++] = 0x0f;
+            out[(*pos)++] = 0xb6;
+            out[(*pos)++] = 0x45 | (reg << 3);
+            out[(*pos)++] = 0x00;
+            bf_log("        inc     ebp\n");
+            out[(*pos)++] = 0x45;
 #else
-        bf_log("        call    r12\n");
-        out[(*pos)++] = 0x41;
-        out[(*pos)++] = 0xff;
-        out[(*pos)++] = 0xd4;
+            bf_log("        movzx   %s, byte ptr[r15]\n", reg_name(reg, 32));
+            write_rex(reg, 15, out, pos);
+            out[(*pos)++] = 0x0f;
+            out[(*pos)++] = 0xb6;
+            out[(*pos)++] = 0x07 | ((reg & 7) << 3);
+            bf_log("        inc     r15\n");
+            out[(*pos)++] = 0x49;
+            out[(*pos)++] = 0xff;
+            out[(*pos)++] = 0xc7;
 #endif
-        bf_log("        mov     byte ptr[" RBX "], al\n");
-        out[(*pos)++] = 0x88;
-        out[(*pos)++] = 0x03;
+        }
         return;
 
     case bf_opcode_copy_mul: {
         // If we are multiplying by zero we ignore it.
-        if ((opcode->amount & 0xFF) == 0 || (opcode->amount >> 8) == 0) // nop
+        if (copy_mul_factor(opcode->amount) == 0 || copy_mul_target(opcode->amount) == 0) // nop
             break;
-        do_multiply(opcode->amount, out, pos);
+        do_multiply(opcode->amount, opcode->offset, out, pos);
         return;
     }
-    case bf_opcode_clear:
-        bf_log("        mov     byte ptr[" RBX "], 0\n");
-        out[(*pos)++] = 0xc6;
-        out[(*pos)++] = 0x03;
-        out[(*pos)++] = 0x00;
+    case bf_opcode_clear: {
+        bf_cached_cell *cached = find_cached_cell(opcode->offset);
+        if (cached != NULL) {
+            bf_log("        xor     %s, %s\n", reg_name(cached->reg, 32), reg_name(cached->reg, 32));
+            write_reg_op(0x31, cached->reg, cached->reg, out, pos);
+            cached->dirty = true;
+            // xor sets the zero flag, and the cell is zero.
+            zero_flag.valid = true;
+            zero_flag.offset = opcode->offset;
+            return;
+        }
+        if (zero_flag.offset == opcode->offset) {
+            zero_flag.valid = false;
+        }
+        bf_log("        mov     " CELL_PTR "[" RBX "%+d], 0\n", opcode->offset * CELL_BYTES);
+        write_cell_opcode(0xc6, out, pos);
+        write_cell_operand(0, opcode->offset, out, pos);
+        write_cell_imm(0, out, pos);
+        return;
+    }
+    case bf_opcode_scan:
+        // The scan moves rbx by an unknown amount.
+        spill_reg_cache(out, pos);
+        reset_reg_cache();
+        write_scan(opcode->amount, out, pos);
+        return;
+    case bf_opcode_check:
+        zero_flag.valid = false;
+        write_check(opcode->amount, opcode->offset, out, pos);
         return;
     default:
         return;
@@ -376,9 +1650,20 @@ static void compile_opcode(bf_opcode *restrict opcode, uint8_t *restrict out, si
 // Writes the cleanup code for our JIT.
 static void write_cleanup_code(uint8_t *restrict out, size_t *restrict pos)
 {
+    // Write out whatever is left in the buffer.
+    write_flush_call(out, pos);
 #ifdef JIT_I386
-    // Clean up code: Restores the stack, pops registers, and returns.
+    // Clean up code: Hands back the input pointer, restores the stack, pops registers,
+    // and returns the cell pointer.
     const uint8_t cleanup[] = {
+        // mov dword ptr[edi + 8], ebp // io->in
+        0x89, 0x6f, 0x08,
+        // mov eax, ebx
+        0x89, 0xd8,
+        // pop edi
+        0x5f,
+        // pop esi
+        0x5e,
         // pop ebx
         0x5b,
         // pop ebp
@@ -387,15 +1672,28 @@ static void write_cleanup_code(uint8_t *restrict out, size_t *restrict pos)
         0xc3,
     };
     bf_log(
+        "        mov     dword ptr[edi + 8], ebp\n"
+        "        mov     eax, ebx\n"
+        "        pop     edi\n"
+        "        pop     esi\n"
         "        pop     ebx\n"
         "        pop     ebp\n"
         "        ret\n"
     );
 #else
-    // Clean up code: Restores the stack, pops registers, and returns.
+    // Clean up code: Hands back the input pointer, restores the stack, pops registers,
+    // and returns the cell pointer.
     const uint8_t cleanup[] = {
+        // mov qword ptr[r12 + 16], r15 // io->in
+        0x4d, 0x89, 0x7c, 0x24, 0x10,
+        // mov rax, rbx
+        0x48, 0x89, 0xd8,
+        // pop r15
+        0x41, 0x5f,
         // pop r14
         0x41, 0x5e,
+        // pop r13
+        0x41, 0x5d,
         // pop r12
         0x41, 0x5c,
         // pop rbx
@@ -405,7 +1703,11 @@ static void write_cleanup_code(uint8_t *restrict out, size_t *restrict pos)
     };
 
     bf_log(
+        "        mov     qword ptr[r12 + 16], r15\n"
+        "        mov     rax, rbx\n"
+        "        pop     r15\n"
         "        pop     r14\n"
+        "        pop     r13\n"
         "        pop     r12\n"
         "        pop     rbx\n"
         "        ret\n"
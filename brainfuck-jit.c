@@ -18,9 +18,15 @@
 #include <stdlib.h> // calloc
 #include <string.h> // memset, memcpy
 #include <stdint.h> // uintN_t, intN_t
+#include <stddef.h> // offsetof
 #ifndef __cplusplus
 #   include <stdbool.h> // bool
 #endif
+#ifdef _WIN32
+#   include <windows.h> // QueryPerformanceCounter
+#else
+#   include <time.h> // clock_gettime
+#endif
 
 #include "brainfuck-jit.h"
 
@@ -38,7 +44,81 @@
 #   define bf_log(...) ((void)0)
 #endif
 
-typedef void (*brainfuck_t)(uint8_t *cells_ptr, int (*putchar_ptr)(int), int (*getchar_ptr)(void));
+#if defined(__cplusplus) && __cplusplus >= 201103L
+#   define bf_thread_local thread_local
+#elif defined(_MSC_VER)
+#   define bf_thread_local __declspec(thread)
+#else
+#   define bf_thread_local __thread
+#endif
+
+// -DPROFILE: Counts how often each loop runs, see brainfuck-profile.h. bf2c and bf2elf
+// write the program out for later, so there is nothing for them to count.
+#if defined(PROFILE) && (defined(C_BACKEND) || defined(ELF_BACKEND))
+#   undef PROFILE
+#endif
+
+// -DCELL_BITS=16 or 32: How wide the cells are. Each width gets its own code paths in
+// the backends, picked at build time.
+#ifndef CELL_BITS
+#   define CELL_BITS 8
+#endif
+#if CELL_BITS == 8
+typedef uint8_t bf_cell;
+#elif CELL_BITS == 16
+typedef uint16_t bf_cell;
+#elif CELL_BITS == 32
+typedef uint32_t bf_cell;
+#else
+#   error "CELL_BITS must be 8, 16, or 32"
+#endif
+#define CELL_BYTES (CELL_BITS / 8)
+#define CELL_MASK ((bf_cell)-1)
+
+// How much output the generated code buffers before calling flush.
+#define BF_OUTPUT_BUFFER_SIZE 4096
+// How much input we read at a time.
+#define BF_INPUT_BUFFER_SIZE 65536
+
+// The runtime state of the generated code. The JIT backends hardcode the layout, so keep
+// the fields pointer sized and in this order.
+typedef struct bf_io {
+    // Where the next '.' goes, and the end of the buffer. The generated code keeps these
+    // in registers and only writes out back before it calls flush.
+    uint8_t *out;
+    uint8_t *out_end;
+    // The next byte ',' reads, and the end of what we have. The generated code keeps
+    // these in registers too, and calls refill when in reaches in_end.
+    uint8_t *in;
+    uint8_t *in_end;
+    // Writes out the buffer and resets out.
+    void (*flush)(struct bf_io *io);
+    // Flushes the output and gets more input. Afterwards, in < in_end.
+    void (*refill)(struct bf_io *io);
+    int (*getchar_ptr)(void);
+    int (*putchar_ptr)(int);
+    // The cells the program may use. Checked builds compare against these, and call
+    // tape_error instead of leaving them. It doesn't return.
+    bf_cell *tape_start;
+    bf_cell *tape_end;
+    void (*tape_error)(struct bf_io *io);
+    uint8_t out_buffer[BF_OUTPUT_BUFFER_SIZE];
+    uint8_t in_buffer[BF_INPUT_BUFFER_SIZE];
+    // stdin, if refill mapped it.
+    uint8_t *in_map;
+    size_t in_map_len;
+#ifdef PROFILE
+    // -DPROFILE: This run's counters, one for each entry of program->profile_sites.
+    uint64_t *profile_counts;
+#endif
+} bf_io;
+
+// C99 has no static_assert. The generated code, bf2elf and brainfuck-wrapper.S find the
+// buffers right after the pointers.
+typedef char bf_io_layout_check[offsetof(bf_io, out_buffer) == 11 * sizeof(void *) ? 1 : -1];
+
+// Generated code runs from cells_ptr, and returns where the pointer ended up.
+typedef bf_cell *(*brainfuck_t)(bf_cell *cells_ptr, bf_io *io);
 
 // Instruction modes. Subtracting is treated as negative addition.
 // All should fit in unsigned char!
@@ -53,14 +133,121 @@ typedef enum {
     bf_opcode_end = ']',
     bf_opcode_clear = '0',
     bf_opcode_copy_mul = '*',
+    bf_opcode_scan = 's', // [>], [<<], etc: moves by amount until it finds a zero
+    bf_opcode_check = '?', // -DCHECKED: cells amount to offset must be on the tape
     bf_opcode_ret = 'r',
     bf_opcode_nop = '\0',// 'n' | ((int)'n' << 8) | ((int)'n' << 16) | ((int)'n' << 24)
 } bf_opcode_type;
 
+// bf_opcode_copy_mul packs the factor into the low COPY_MUL_BITS of amount, and the
+// distance from the source to the target cell above it. 8 bits of factor is exact for
+// 8-bit cells, wider cells get 16, and update_copyloop() skips loops that don't fit.
+#if CELL_BITS == 8
+#   define COPY_MUL_BITS 8
+#else
+#   define COPY_MUL_BITS 16
+#endif
+
+// The sign extended factor of a copy_mul.
+static inline int32_t copy_mul_factor(int32_t amount)
+{
+    int32_t factor = amount & ((1 << COPY_MUL_BITS) - 1);
+    return factor >= 1 << (COPY_MUL_BITS - 1) ? factor - (1 << COPY_MUL_BITS) : factor;
+}
+
+// Where the target of a copy_mul is, relative to its source.
+static inline int32_t copy_mul_target(int32_t amount)
+{
+    return amount >> COPY_MUL_BITS;
+}
+
 typedef struct {
     int op;
     int32_t amount;
+    // Which cell we operate on, relative to the pointer. See sink_moves().
+    int32_t offset;
+#ifdef PROFILE
+    // -DPROFILE: Set on the op a loop turned into. The parser stores where the '[' was
+    // plus one, and number_profile_sites() replaces it with the counter plus one.
+    uint32_t site;
+#endif
 } bf_opcode;
+
+// -DTIERED and -DLAZY: Native code for one loop, see brainfuck-jit-loops.h.
+typedef struct {
+    void *code;
+    size_t code_len;
+} bf_loop_code;
+
+// -DPROFILE: A loop we count, see brainfuck-profile.h.
+typedef struct {
+    // Where the '[' is in the source.
+    uint32_t source;
+    // What the loop compiled to: bf_opcode_start if it is still a loop, otherwise a
+    // clear, copy/multiply or scan.
+    int op;
+    // The total of every run so far.
+    uint64_t count;
+} bf_profile_site;
+
+// Where a loop is in the source, from its '[' to its ']'.
+typedef struct {
+    uint32_t start;
+    uint32_t end;
+} bf_source_span;
+
+// A compiled program. The IR is filled in by brainfuck_compile(), and the backend
+// turns it into something runnable in prepare_opcodes().
+struct brainfuck_program {
+    bf_opcode *opcodes;
+    size_t opcodes_len;
+    // Native code from the JIT backends, or the interpreter's decoded program.
+    void *code;
+    // Size of the mapping, and how much of it is actually code.
+    size_t code_len;
+    size_t code_size;
+    int optlevel;
+    // What analyze_tape() found. If tape_bounded, the program only ever touches cells
+    // tape_min to tape_max.
+    bool tape_bounded;
+    int32_t tape_min;
+    int32_t tape_max;
+    // The longest scan stride, which the padding around a heap tape has to cover.
+    int32_t tape_stride;
+    // -DTIERED: One entry per loop, filled in as the loops get hot. -DLAZY: One entry
+    // per top-level loop, filled in the first time they run.
+    bf_loop_code *loop_code;
+    size_t loop_code_len;
+    // brainfuck_set_perf_map(): Where each loop that is still a loop came from, in the
+    // order of their start ops. NULL if perf is off.
+    bf_source_span *loop_spans;
+    size_t loop_spans_len;
+    // How long each phase of brainfuck_compile() took, in seconds.
+    size_t source_len;
+    double parse_time;
+    double optimize_time;
+    double codegen_time;
+#ifdef PROFILE
+    // -DPROFILE: The loops in the order of their counters.
+    bf_profile_site *profile_sites;
+    size_t profile_sites_len;
+#endif
+};
+
+// What run_opcodes() returns when the program didn't run to the end, which is also what
+// brainfuck_job.status gets.
+#define BF_OUT_OF_MEMORY (-1)
+#define BF_RAN_OFF_TAPE (-2)
+
+// -DCHECKED: Bounds checks the tape in software, see insert_bounds_checks().
+#ifdef CHECKED
+#   define BF_CHECKED 1
+#else
+#   define BF_CHECKED 0
+#endif
+#ifdef PROFILE
+#   include "brainfuck-profile.h"
+#endif
 #ifdef C_BACKEND
 #include "brainfuck-backend-c.h"
 #else
@@ -75,9 +262,46 @@ typedef struct {
 #endif
 
 #if JIT_MODE == 0
+#   include "brainfuck-io.h"
 #   include "brainfuck-interp.h"
 #else
 
+// Loop alignment: The body of each innermost loop, where its backwards branch lands, is
+// padded with nops to a LOOP_ALIGN byte boundary, so a hot loop doesn't straddle more
+// fetch blocks than it needs to. The nops only run on the way in. Padding that would take
+// more than LOOP_ALIGN_MAX_SKIP bytes is skipped. -DLOOP_ALIGN=0 turns it off.
+#ifndef LOOP_ALIGN
+#   define LOOP_ALIGN 16
+#endif
+#ifndef LOOP_ALIGN_MAX_SKIP
+#   define LOOP_ALIGN_MAX_SKIP (LOOP_ALIGN > 0 ? LOOP_ALIGN - 1 : 0)
+#endif
+
+// -DTIERED already compiles loops as they are needed, so it wins over -DLAZY, and bf2elf
+// compiles everything ahead of time anyway.
+#if (defined(TIERED) || defined(ELF_BACKEND)) && defined(LAZY)
+#   undef LAZY
+#endif
+
+// How many bytes of padding the body of the loop at start gets if it starts at byte pos
+// of the code. Call it before the backend overwrites start->amount.
+static size_t loop_padding(const bf_opcode *start, size_t pos)
+{
+#if LOOP_ALIGN > 1
+    // Outer loops are left alone, the inner ones are where the time goes.
+    for (int32_t i = 1; i < start->amount; i++) {
+        if (start[i].op == bf_opcode_start) {
+            return 0;
+        }
+    }
+    size_t pad = (LOOP_ALIGN - pos % LOOP_ALIGN) % LOOP_ALIGN;
+    return pad <= LOOP_ALIGN_MAX_SKIP ? pad : 0;
+#else
+    (void)start, (void)pos;
+    return 0;
+#endif
+}
+
 // Should include the following implementations:
 //    // The longest instruction for allocating a large enough buffer
 //    #define MAX_INSN_LEN N
@@ -85,6 +309,14 @@ typedef struct {
 //    #define INIT_LEN N
 //    // The size of the cleanup routine
 //    #define CLEANUP_LEN N
+//    // The calling convention of the generated code, for the code cache
+//    #define JIT_ABI "name"
+//    // The longest bf_opcode_scan
+//    #define MAX_SCAN_LEN N
+//    // The longest bf_opcode_check
+//    #define MAX_CHECK_LEN N
+//    // Optional instruction sets the generated code depends on, for the code cache
+//    static uint32_t jit_cpu_features(void)
 //    // Converts a bf_opcode into native code, incrementing pos
 //    static void compile_opcode(bf_opcode *restrict opcode, uint8_t *restrict out, size_t *restrict pos)
 
@@ -100,27 +332,243 @@ typedef struct {
 
 // should include the following implementations:
 //     // Allocates the opcodes.
-//     static unsigned char *alloc_opcodes(size_t amount);
-//     // Executes the code.
-//     static void run_opcodes(unsigned char *buf, size_t len, unsigned char *cells);
+//     static raw_opcode *alloc_opcodes(size_t amount);
+//     // Marks the opcodes as R^X.
+//     static void protect_opcodes(raw_opcode *buf, size_t len);
 //     // Deallocates the opcodes
-//     static void dealloc_opcodes(unsigned char *buf, size_t len);
+//     static void dealloc_opcodes(raw_opcode *buf, size_t len);
+//     // Where there is a guard page tape, defines HAVE_GUARD_TAPE and runs the generated
+//     // code on a fresh one. Returns 0, BF_OUT_OF_MEMORY or BF_RAN_OFF_TAPE.
+//     static int run_on_tape(brainfuck_t fuck, bf_io *io);
+
+// Worst case size of the code for one opcode in bytes.
+static size_t max_opcode_len(const bf_opcode *op)
+{
+    size_t len = 0;
+#ifdef PROFILE
+    if (op->site != 0) {
+        len += MAX_PROFILE_LEN;
+    }
+#endif
+    if (op->op == bf_opcode_scan) {
+        return len + MAX_SCAN_LEN;
+    } else if (op->op == bf_opcode_check) {
+        return len + MAX_CHECK_LEN;
+    } else if (op->op == bf_opcode_start) {
+        return len + MAX_INSN_LEN + LOOP_ALIGN_MAX_SKIP;
+    } else {
+        return len + MAX_INSN_LEN;
+    }
+}
 
-#  if defined(_WIN32) || defined(__CYGWIN__)
-#     include "brainfuck-jit-mmap-windows.h"
-#  elif defined(__unix__) || defined(__APPLE__)
-#     include "brainfuck-jit-mmap-unix.h"
+// Worst case size of the compiled code in bytes.
+static size_t max_code_len(const bf_opcode *ir, size_t len)
+{
+    size_t memlen = INIT_LEN + CLEANUP_LEN;
+    for (size_t i = 0; i < len; i++) {
+        memlen += max_opcode_len(&ir[i]);
+    }
+    return memlen;
+}
+
+#  ifdef ELF_BACKEND
+#     include "brainfuck-backend-elf.h"
 #  else
-#     error "Unknown OS!"
+#     if defined(_WIN32) || defined(__CYGWIN__)
+#        include "brainfuck-jit-mmap-windows.h"
+#     elif defined(__unix__) || defined(__APPLE__)
+#        include "brainfuck-jit-mmap-unix.h"
+#     else
+#        error "Unknown OS!"
+#     endif
+#     include "brainfuck-io.h"
+#     ifdef __linux__
+#        include "brainfuck-jit-perf-linux.h"
+#     endif
+// Only x86 has the stubs for -DLAZY, the other backends compile everything up front.
+#     if defined(LAZY) && !defined(HAVE_LAZY_LOOPS)
+#        undef LAZY
+#     endif
+#     if defined(TIERED) || defined(LAZY)
+#        include "brainfuck-jit-loops.h"
+#     endif
+#     ifdef TIERED
+#        include "brainfuck-jit-tiered.h"
+#     else
+#        include "brainfuck-jit-runner.h"
+#     endif
+// Tiered programs are mostly IR, and lazy ones have the addresses of their loops baked
+// in, so neither can be cached. Profiled ones need the parser to find their loops.
+#     if (defined(__unix__) || defined(__APPLE__)) && !defined(TIERED) && !defined(LAZY) && !defined(PROFILE)
+#        include "brainfuck-jit-cache-unix.h"
+#     endif
 #  endif
-#  include "brainfuck-jit-runner.h"
 #endif
 #endif
+
+// Only the unix JIT can map code straight from disk.
+#ifndef HAVE_CODE_CACHE
+static uint64_t cache_key(const char *code, size_t len, int optlevel)
+{
+    (void)code;
+    (void)len;
+    (void)optlevel;
+    return 0;
+}
+
+static bool load_cached_code(brainfuck_program *restrict program, const char *restrict dir, uint64_t key, const char *restrict code, size_t len)
+{
+    (void)program;
+    (void)dir;
+    (void)key;
+    (void)code;
+    (void)len;
+    return false;
+}
+
+static void store_cached_code(const brainfuck_program *restrict program, const char *restrict dir, uint64_t key, const char *restrict code, size_t len)
+{
+    (void)program;
+    (void)dir;
+    (void)key;
+    (void)code;
+    (void)len;
+}
+#endif
+
+// Only the Linux JIT has anything to show perf.
+#ifndef HAVE_PERF_MAP
+static bool perf_enabled(void)
+{
+    return false;
+}
+
+static void start_perf_map(int flags)
+{
+    (void)flags;
+}
+
+static void perf_code(const void *code, size_t size, const char *name)
+{
+    (void)code;
+    (void)size;
+    (void)name;
+}
+#endif
+// Every backend provides the following:
+//     // Turns program->opcodes into something runnable. Returns false on failure.
+//     static bool prepare_opcodes(brainfuck_program *program);
+//     // Runs a prepared program on a fresh tape. Must be thread safe. Returns 0,
+//     // BF_OUT_OF_MEMORY or BF_RAN_OFF_TAPE, without printing anything.
+//     static int run_opcodes(brainfuck_program *program, int (*putchar_ptr)(int), int (*getchar_ptr)(void));
+//     // Frees anything prepare_opcodes() allocated.
+//     static void release_opcodes(brainfuck_program *program);
 #include "brainfuck-ir.h"
 
+// Where to keep compiled code, or NULL to not cache it.
+static char *cache_dir = NULL;
 
-// Executes the code with light JIT optimization.
-void brainfuck(const char *code, size_t len, int optlevel)
+// Sets the directory for the on-disk code cache.
+void brainfuck_set_cache_dir(const char *dir)
+{
+    free(cache_dir);
+    cache_dir = dir ? strdup(dir) : NULL;
+}
+
+// Seconds since some point in the past, for timing the compiler.
+static double bf_seconds(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER now, frequency;
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&frequency);
+    return (double)now.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+// Turns perf output on or off.
+void brainfuck_set_perf_map(int flags)
+{
+    start_perf_map(flags);
+}
+
+// The parser's record of where the loops are, for perf. Every '[' gets a span in
+// order, and the ones that don't stay loops are dropped at the end.
+typedef struct {
+    // NULL if perf is off.
+    bf_source_span *spans;
+    size_t len;
+    // The span of each open loop, by nesting depth.
+    uint32_t *open;
+} bf_span_parser;
+
+static void begin_loop_spans(bf_span_parser *restrict parser, size_t len)
+{
+    parser->spans = NULL;
+    parser->open = NULL;
+    parser->len = 0;
+    if (perf_enabled()) {
+        parser->spans = (bf_source_span *)malloc((len + 1) * sizeof(bf_source_span));
+        parser->open = (uint32_t *)malloc((len + 1) * sizeof(uint32_t));
+        if (!parser->spans || !parser->open) {
+            // Then perf gets loop numbers instead.
+            free(parser->spans);
+            free(parser->open);
+            parser->spans = NULL;
+            parser->open = NULL;
+        }
+    }
+}
+
+// A '[' at position i in the source, depth loops in.
+static void open_loop_span(bf_span_parser *restrict parser, size_t depth, size_t i)
+{
+    if (parser->spans) {
+        parser->spans[parser->len].start = (uint32_t)i;
+        parser->spans[parser->len].end = UINT32_MAX;
+        parser->open[depth] = (uint32_t)parser->len++;
+    }
+}
+
+// A ']' at position i that closed a loop which stays a loop.
+static void close_loop_span(bf_span_parser *restrict parser, size_t depth, size_t i)
+{
+    if (parser->spans) {
+        parser->spans[parser->open[depth]].end = (uint32_t)i;
+    }
+}
+
+static void free_loop_spans(bf_span_parser *restrict parser)
+{
+    free(parser->spans);
+    free(parser->open);
+    parser->spans = NULL;
+    parser->open = NULL;
+}
+
+// Hands the spans of the loops that are left to the program.
+static void finish_loop_spans(bf_span_parser *restrict parser, brainfuck_program *restrict program)
+{
+    size_t len = 0;
+    for (size_t i = 0; i < parser->len; i++) {
+        if (parser->spans[i].end != UINT32_MAX) {
+            parser->spans[len++] = parser->spans[i];
+        }
+    }
+    if (parser->spans) {
+        program->loop_spans = parser->spans;
+        program->loop_spans_len = len;
+        parser->spans = NULL;
+    }
+    free_loop_spans(parser);
+}
+
+// Parses and compiles the code with light JIT optimization.
+brainfuck_program *brainfuck_compile(const char *code, size_t len, int optlevel)
 {
     int32_t mode = bf_opcode_nop, combine = 0;
     bool leaf = false;
@@ -133,12 +581,32 @@ void brainfuck(const char *code, size_t len, int optlevel)
         }
     }
 
+    double start_time = bf_seconds();
+    uint64_t key = 0;
+    if (cache_dir) {
+        key = cache_key(code, len, optlevel);
+        brainfuck_program *program = (brainfuck_program *)calloc(1, sizeof(brainfuck_program));
+        if (!program) {
+            printf("out of memory\n");
+            return NULL;
+        }
+        program->optlevel = optlevel;
+        if (load_cached_code(program, cache_dir, key, code, len)) {
+            // Loading it is all the codegen we do.
+            program->source_len = len;
+            program->codegen_time = bf_seconds() - start_time;
+            perf_code(program->code, program->code_size, "bf:cached");
+            return program;
+        }
+        free(program);
+    }
+
     // Our stack to hold loop pointers. We use the worst case scenario in which every char is a loop starter so we don't need to realloc.
     // This prevents a lot of checking at the cost of more memory.
     bf_opcode **loops = (bf_opcode **)malloc(len * sizeof(bf_opcode *));
     if (!loops) {
         printf("out of memory\n");
-        exit(1);
+        return NULL;
     }
     bf_opcode **loops_iterator = loops;
 
@@ -147,15 +615,15 @@ void brainfuck(const char *code, size_t len, int optlevel)
     if (!opcodes) {
         printf("out of memory\n");
         free(loops);
-        exit(1);
+        return NULL;
     }
 
     bf_opcode *opcodes_iterator = opcodes;
+    bf_span_parser spans;
+    begin_loop_spans(&spans, len);
 
-    // -O0 disables all optimizations, and uses unbuffered stdin.
+    // -O0 disables all optimizations.
     if (optlevel < 1) {
-        setvbuf(stdout, NULL, _IONBF, 0);
-
         for (size_t i = 0; i < len; i++) {
             combine = 1;
             int op = code[i];
@@ -169,6 +637,10 @@ void brainfuck(const char *code, size_t len, int optlevel)
                 combine = -1;
                 break;
             case bf_opcode_start:
+#ifdef PROFILE
+                opcodes_iterator->site = (uint32_t)i + 1;
+#endif
+                open_loop_span(&spans, loops_iterator - loops, i);
                 *loops_iterator++ = opcodes_iterator; // push the address of the next opcode to the stack
                 break;
             case bf_opcode_end: {
@@ -176,11 +648,13 @@ void brainfuck(const char *code, size_t len, int optlevel)
                     printf("position %zu: Extra ']'n", i);
                     free(loops);
                     free(opcodes);
-                    exit(1);
+                    free_loop_spans(&spans);
+                    return NULL;
                 }
                 // Pop from our stack
                 bf_opcode *start = *--loops_iterator;
                 fill_in_jump(start, &opcodes_iterator, false);
+                close_loop_span(&spans, loops_iterator - loops, i);
                 commit(op, combine, &opcodes_iterator);
                 continue;
             }
@@ -240,6 +714,12 @@ void brainfuck(const char *code, size_t len, int optlevel)
                 mode = bf_opcode_start;
                 combine = 0;
                 leaf = true;
+#ifdef PROFILE
+                // The next commit() is the '[', and clear, copy and scan loops are
+                // written over it.
+                opcodes_iterator->site = (uint32_t)i + 1;
+#endif
+                open_loop_span(&spans, loops_iterator - loops, i);
                 *loops_iterator++ = opcodes_iterator; // push the address of the next opcode to the stack
                 break;
             case bf_opcode_end: { // end loop
@@ -247,7 +727,8 @@ void brainfuck(const char *code, size_t len, int optlevel)
                     printf("position %zu: Extra ']'n", i);
                     free(loops);
                     free(opcodes);
-                    exit(1);
+                    free_loop_spans(&spans);
+                    return NULL;
                 }
                 // Pop from our stack
                 bf_opcode *start = *--loops_iterator;
@@ -269,11 +750,22 @@ void brainfuck(const char *code, size_t len, int optlevel)
                      break;
                 }
 
+                // Same thing for scan loops ([>], [<<], etc), which look for a zero cell.
+                if (optlevel > 1 && start == opcodes_iterator - 1 && mode == bf_opcode_move && combine != 0) {
+                     bf_log("converting scan loop!!!\n");
+                     write_scan_loop(start, &opcodes_iterator, combine);
+                     mode = bf_opcode_nop;
+                     combine = 0;
+                     break;
+                }
+
                 commit(mode, combine, &opcodes_iterator);
                 mode = bf_opcode_end;
                 combine = 0;
                 if (fill_in_jump(start, &opcodes_iterator, optlevel > 1 && leaf)) {
                     mode = bf_opcode_nop;
+                } else {
+                    close_loop_span(&spans, loops_iterator - loops, i);
                 }
                 leaf = false; // not in a leaf anymore
                 break;
@@ -301,15 +793,124 @@ void brainfuck(const char *code, size_t len, int optlevel)
         printf("Position %zu: Missing ]\n", len - 1);
         free(opcodes);
         free(loops);
-        exit(1);
+        free_loop_spans(&spans);
+        return NULL;
+    }
+    double parse_time = bf_seconds();
+
+    if (optlevel > 1) {
+        opcodes_len = sink_moves(opcodes, opcodes_len, loops);
     }
 
     // We don't need this anymore.
     free(loops);
 
+    brainfuck_program *program = (brainfuck_program *)calloc(1, sizeof(brainfuck_program));
+    if (!program) {
+        printf("out of memory\n");
+        free(opcodes);
+        free_loop_spans(&spans);
+        return NULL;
+    }
+    program->opcodes = opcodes;
+    program->opcodes_len = opcodes_len;
+    finish_loop_spans(&spans, program);
+    program->optlevel = optlevel;
+    program->source_len = len;
+
+    if (!analyze_tape(program)) {
+        printf("out of memory\n");
+        brainfuck_free(program);
+        return NULL;
+    }
+#ifdef PROFILE
+    if (!number_profile_sites(program)) {
+        printf("out of memory\n");
+        brainfuck_free(program);
+        return NULL;
+    }
+#endif
+
+    double optimize_time = bf_seconds();
+
+    // Convert to machine code
+    if (!prepare_opcodes(program)) {
+        printf("out of memory\n");
+        brainfuck_free(program);
+        return NULL;
+    }
+    double codegen_time = bf_seconds();
+    program->parse_time = parse_time - start_time;
+    program->optimize_time = optimize_time - parse_time;
+    program->codegen_time = codegen_time - optimize_time;
+    if (cache_dir && program->code) {
+        store_cached_code(program, cache_dir, key, code, len);
+    }
+    return program;
+}
+
+// Reports what brainfuck_compile() did with the program.
+void brainfuck_get_compile_stats(const brainfuck_program *program, brainfuck_compile_stats *stats)
+{
+    stats->source_len = program->source_len;
+    stats->opcodes_len = program->opcodes_len;
+    stats->code_size = program->code_size;
+    stats->parse_time = program->parse_time;
+    stats->optimize_time = program->optimize_time;
+    stats->codegen_time = program->codegen_time;
+}
+
+// Runs a compiled program on a fresh tape with stdio, and says what went wrong if it
+// didn't finish.
+int brainfuck_run(brainfuck_program *program)
+{
+    // -O0 uses unbuffered stdout.
+    if (program->optlevel < 1) {
+        setvbuf(stdout, NULL, _IONBF, 0);
+    }
+    int status = run_opcodes(program, &putchar, &getchar);
+    if (status == BF_OUT_OF_MEMORY) {
+        printf("Out of memory\n");
+    } else if (status == BF_RAN_OFF_TAPE) {
+        fflush(stdout);
+        fprintf(stderr, "Error: the program ran off the tape\n");
+    }
+    return status;
+}
+
+// Runs a compiled program on a fresh tape with custom I/O.
+int brainfuck_run_io(brainfuck_program *program, int (*putchar_ptr)(int), int (*getchar_ptr)(void))
+{
+    return run_opcodes(program, putchar_ptr, getchar_ptr);
+}
+
+// Frees a compiled program.
+void brainfuck_free(brainfuck_program *program)
+{
+    if (!program) {
+        return;
+    }
+#ifdef PROFILE
+    print_profile(program);
+    free(program->profile_sites);
+#endif
+    release_opcodes(program);
+    free(program->loop_spans);
+    free(program->opcodes);
+    free(program);
+}
 
-    // Convert to machine code and run
-    run_opcodes(opcodes, opcodes_len);
-    free(opcodes);
+// Executes the code with light JIT optimization.
+void brainfuck(const char *code, size_t len, int optlevel)
+{
+    brainfuck_program *program = brainfuck_compile(code, len, optlevel);
+    if (!program) {
+        exit(1);
+    }
+    int status = brainfuck_run(program);
+    brainfuck_free(program);
+    if (status != 0) {
+        exit(1);
+    }
 }
 
@@ -26,6 +26,138 @@ extern "C" {
  */
 void brainfuck(const char *code, size_t len, int optlevel);
 
+/**
+ * brainfuck_program
+ *
+ * An opaque handle to a compiled Brainfuck program.
+ */
+typedef struct brainfuck_program brainfuck_program;
+
+/**
+ * brainfuck_compile()
+ *
+ * Compiles a Brainfuck string once so it can be run many times. Returns NULL on error.
+ */
+brainfuck_program *brainfuck_compile(const char *code, size_t len, int optlevel);
+
+/**
+ * brainfuck_run()
+ *
+ * Runs a compiled program on a fresh tape. Returns 0, -1 if we ran out of memory, or -2
+ * if the program ran off the tape. The error is printed.
+ *
+ * stdin is read in big chunks (or mapped, if it is a file) instead of through stdio. What
+ * the program didn't get to is put back if stdin is seekable, and lost if it is a pipe.
+ */
+int brainfuck_run(brainfuck_program *program);
+
+/**
+ * brainfuck_run_io()
+ *
+ * Runs a compiled program on a fresh tape, using putchar_ptr and getchar_ptr instead of stdio.
+ * getchar_ptr should return EOF at the end of input. This is safe to call from multiple
+ * threads on the same program. Returns the same as brainfuck_run(), but prints nothing.
+ */
+int brainfuck_run_io(brainfuck_program *program, int (*putchar_ptr)(int), int (*getchar_ptr)(void));
+
+/**
+ * brainfuck_free()
+ *
+ * Frees a compiled program and its executable memory.
+ */
+void brainfuck_free(brainfuck_program *program);
+
+/**
+ * brainfuck_compile_stats
+ *
+ * What brainfuck_compile() did with a program, see brainfuck_get_compile_stats().
+ */
+typedef struct {
+    // The length of the source.
+    size_t source_len;
+    // How many IR ops it became, after optimization.
+    size_t opcodes_len;
+    // How many bytes of machine code were generated, or of decoded instructions for the
+    // interpreter. 0 for bf2c.
+    size_t code_size;
+    // How long parsing the source into IR, optimizing the IR, and turning it into
+    // something runnable took, in seconds. A program loaded from the code cache only
+    // has a codegen_time.
+    double parse_time;
+    double optimize_time;
+    double codegen_time;
+} brainfuck_compile_stats;
+
+/**
+ * brainfuck_get_compile_stats()
+ *
+ * Fills in stats for a compiled program.
+ */
+void brainfuck_get_compile_stats(const brainfuck_program *program, brainfuck_compile_stats *stats);
+
+/**
+ * brainfuck_set_cache_dir()
+ *
+ * Enables the on-disk code cache in dir, or disables it if dir is NULL. Compiled code
+ * is stored there and mapped back in on the next brainfuck_compile() of the same source.
+ *
+ * The directory should only be writable by you, as anything in it gets executed.
+ */
+void brainfuck_set_cache_dir(const char *dir);
+
+/**
+ * brainfuck_set_perf_map()
+ *
+ * Tells Linux perf where the generated code is, so profiles show which loop of the
+ * source is hot instead of [unknown]. flags is any of:
+ *
+ *  - BRAINFUCK_PERF_MAP: Append each code range to /tmp/perf-<pid>.map.
+ *  - BRAINFUCK_PERF_JITDUMP: Write /tmp/jit-<pid>.dump for `perf inject --jit`, which
+ *    also lets perf annotate the code. Record with `perf record -k mono`.
+ *
+ * Only programs compiled afterwards are listed. 0 stops it. This does nothing outside of
+ * the Linux JIT.
+ */
+#define BRAINFUCK_PERF_MAP 1
+#define BRAINFUCK_PERF_JITDUMP 2
+void brainfuck_set_perf_map(int flags);
+
+/**
+ * brainfuck_job
+ *
+ * One program and its input for brainfuck_run_jobs().
+ */
+typedef struct {
+    // The program to run.
+    const char *code;
+    size_t len;
+    // What ',' reads.
+    const char *input;
+    size_t input_len;
+    // What '.' wrote, filled in by brainfuck_run_jobs(). Free it with free().
+    char *output;
+    size_t output_len;
+    // Filled in with 0 on success, -1 if we ran out of memory, -2 if it ran off the tape,
+    // or -3 if it didn't compile. output has what it wrote before that.
+    int status;
+} brainfuck_job;
+
+/**
+ * brainfuck_run_jobs()
+ *
+ * Compiles and runs independent programs on nthreads threads, or one per core if nthreads is 0.
+ * Each job gets its own tape and I/O buffers. Returns the number of jobs that failed.
+ */
+size_t brainfuck_run_jobs(brainfuck_job *jobs, size_t njobs, int optlevel, int nthreads);
+
+/**
+ * brainfuck_run_batch()
+ *
+ * Like brainfuck_run_jobs(), but runs one compiled program over every job's input.
+ * The jobs' code is ignored. Returns the number of jobs that failed.
+ */
+size_t brainfuck_run_batch(brainfuck_program *program, brainfuck_job *jobs, size_t njobs, int nthreads);
+
 #ifdef __cplusplus
 }
 #endif
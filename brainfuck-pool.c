@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2019 easyaspi314
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ */
+
+/// brainfuck-pool.c: Runs many jobs on a thread pool.
+///
+/// Jobs are either independent programs, or in batch mode, one compiled program run over
+/// many inputs. Compiled programs are read-only once prepared, so in batch mode every
+/// worker runs the same code with its own tape.
+///
+/// Every worker owns a slice of the jobs array as a deque. It takes jobs from the front
+/// of its own slice, and when that runs dry, it steals from the back of someone else's.
+/// Jobs never spawn more jobs, so once every deque is empty we are done.
+///
+/// The generated code calls plain putchar/getchar style function pointers, so the
+/// current job's I/O buffers are kept in a thread local.
+
+#include <stdio.h> // EOF
+#include <stdlib.h> // malloc, realloc
+#include <string.h> // memset
+#ifndef __cplusplus
+#   include <stdbool.h> // bool
+#endif
+
+#include "brainfuck-jit.h"
+
+#ifdef _WIN32
+#   include <windows.h>
+#else
+#   include <pthread.h>
+#   include <unistd.h> // sysconf
+#endif
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+#   define bf_thread_local thread_local
+#elif defined(_MSC_VER)
+#   define bf_thread_local __declspec(thread)
+#else
+#   define bf_thread_local __thread
+#endif
+
+// The job the current thread is running.
+static bf_thread_local brainfuck_job *current_job;
+static bf_thread_local size_t input_pos;
+static bf_thread_local size_t output_cap;
+// Set if the output didn't fit in memory, so the job fails instead of coming back short.
+static bf_thread_local bool output_failed;
+
+static int job_putchar(int c)
+{
+    brainfuck_job *job = current_job;
+    if (output_failed) {
+        return EOF;
+    }
+    if (job->output_len == output_cap) {
+        size_t cap = output_cap ? output_cap * 2 : 256;
+        char *output = (char *)realloc(job->output, cap);
+        if (!output) {
+            output_failed = true;
+            return EOF;
+        }
+        job->output = output;
+        output_cap = cap;
+    }
+    job->output[job->output_len++] = (char)c;
+    return c;
+}
+
+static int job_getchar(void)
+{
+    brainfuck_job *job = current_job;
+    if (input_pos >= job->input_len) {
+        return EOF;
+    }
+    return (unsigned char)job->input[input_pos++];
+}
+
+// Runs one job with its own I/O buffers. If we weren't given a shared program, the job
+// brings its own source and we compile it.
+static bool run_job(brainfuck_job *job, brainfuck_program *shared, int optlevel)
+{
+    job->output = NULL;
+    job->output_len = 0;
+
+    brainfuck_program *program = shared;
+    if (!program) {
+        program = brainfuck_compile(job->code, job->len, optlevel);
+        if (!program) {
+            job->status = -3;
+            return false;
+        }
+    }
+    current_job = job;
+    input_pos = 0;
+    output_cap = 0;
+    output_failed = false;
+    int status = brainfuck_run_io(program, &job_putchar, &job_getchar);
+    current_job = NULL;
+    if (!shared) {
+        brainfuck_free(program);
+    }
+    job->status = status == 0 && output_failed ? -1 : status;
+    return job->status == 0;
+}
+
+// The little we need from threads: SRW locks and CreateThread() on Windows, pthreads
+// everywhere else.
+#ifdef _WIN32
+typedef SRWLOCK bf_mutex;
+typedef HANDLE bf_thread;
+
+static void mutex_init(bf_mutex *mutex)
+{
+    InitializeSRWLock(mutex);
+}
+
+// SRW locks don't need to be destroyed.
+static void mutex_destroy(bf_mutex *mutex)
+{
+    (void)mutex;
+}
+
+static void mutex_lock(bf_mutex *mutex)
+{
+    AcquireSRWLockExclusive(mutex);
+}
+
+static void mutex_unlock(bf_mutex *mutex)
+{
+    ReleaseSRWLockExclusive(mutex);
+}
+
+static int count_cpus(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+#else
+typedef pthread_mutex_t bf_mutex;
+typedef pthread_t bf_thread;
+
+static void mutex_init(bf_mutex *mutex)
+{
+    pthread_mutex_init(mutex, NULL);
+}
+
+static void mutex_destroy(bf_mutex *mutex)
+{
+    pthread_mutex_destroy(mutex);
+}
+
+static void mutex_lock(bf_mutex *mutex)
+{
+    pthread_mutex_lock(mutex);
+}
+
+static void mutex_unlock(bf_mutex *mutex)
+{
+    pthread_mutex_unlock(mutex);
+}
+
+static int count_cpus(void)
+{
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return ncpus > 0 ? (int)ncpus : 1;
+}
+#endif
+
+// A worker's share of the jobs, [head, tail).
+typedef struct {
+    bf_mutex lock;
+    size_t head;
+    size_t tail;
+} bf_deque;
+
+typedef struct bf_pool bf_pool;
+
+typedef struct {
+    bf_pool *pool;
+    bf_thread thread;
+    int id;
+    size_t failed;
+} bf_worker;
+
+struct bf_pool {
+    brainfuck_job *jobs;
+    // Shared by every job in batch mode, otherwise NULL.
+    brainfuck_program *program;
+    bf_deque *deques;
+    bf_worker *workers;
+    int nthreads;
+    int optlevel;
+};
+
+// Takes the next job from the front of our own deque.
+static bool pop_job(bf_deque *deque, size_t *out)
+{
+    bool found = false;
+    mutex_lock(&deque->lock);
+    if (deque->head < deque->tail) {
+        *out = deque->head++;
+        found = true;
+    }
+    mutex_unlock(&deque->lock);
+    return found;
+}
+
+// Takes a job from the back of someone else's deque.
+static bool steal_job(bf_deque *deque, size_t *out)
+{
+    bool found = false;
+    mutex_lock(&deque->lock);
+    if (deque->head < deque->tail) {
+        *out = --deque->tail;
+        found = true;
+    }
+    mutex_unlock(&deque->lock);
+    return found;
+}
+
+static void *worker_main(void *arg)
+{
+    bf_worker *worker = (bf_worker *)arg;
+    bf_pool *pool = worker->pool;
+    size_t job;
+
+    for (;;) {
+        if (!pop_job(&pool->deques[worker->id], &job)) {
+            // Our deque is empty, go steal from the others, starting with our neighbor.
+            bool stole = false;
+            for (int i = 1; i < pool->nthreads && !stole; i++) {
+                stole = steal_job(&pool->deques[(worker->id + i) % pool->nthreads], &job);
+            }
+            if (!stole) {
+                break;
+            }
+        }
+        worker->failed += !run_job(&pool->jobs[job], pool->program, pool->optlevel);
+    }
+    return NULL;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI worker_thread(LPVOID arg)
+{
+    worker_main(arg);
+    return 0;
+}
+
+static bool start_thread(bf_thread *thread, bf_worker *worker)
+{
+    *thread = CreateThread(NULL, 0, &worker_thread, worker, 0, NULL);
+    return *thread != NULL;
+}
+
+static void join_thread(bf_thread thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+#else
+static bool start_thread(bf_thread *thread, bf_worker *worker)
+{
+    return pthread_create(thread, NULL, &worker_main, worker) == 0;
+}
+
+static void join_thread(bf_thread thread)
+{
+    pthread_join(thread, NULL);
+}
+#endif
+
+static size_t run_pool(brainfuck_job *jobs, size_t njobs, brainfuck_program *program, int optlevel, int nthreads)
+{
+    if (nthreads <= 0) {
+        nthreads = count_cpus();
+    }
+    if ((size_t)nthreads > njobs) {
+        nthreads = njobs > 0 ? (int)njobs : 1;
+    }
+
+    bf_pool pool;
+    pool.jobs = jobs;
+    pool.program = program;
+    pool.nthreads = nthreads;
+    pool.optlevel = optlevel;
+    pool.deques = (bf_deque *)calloc(nthreads, sizeof(bf_deque));
+    pool.workers = (bf_worker *)calloc(nthreads, sizeof(bf_worker));
+    if (!pool.deques || !pool.workers) {
+        printf("out of memory\n");
+        free(pool.deques);
+        free(pool.workers);
+        return njobs;
+    }
+
+    // Split the jobs evenly, the stealing takes care of the rest.
+    for (int i = 0; i < nthreads; i++) {
+        mutex_init(&pool.deques[i].lock);
+        pool.deques[i].head = njobs * i / nthreads;
+        pool.deques[i].tail = njobs * (i + 1) / nthreads;
+        pool.workers[i].pool = &pool;
+        pool.workers[i].id = i;
+    }
+
+    // Worker 0 is the calling thread.
+    int started = 1;
+    for (; started < nthreads; started++) {
+        if (!start_thread(&pool.workers[started].thread, &pool.workers[started])) {
+            break;
+        }
+    }
+    worker_main(&pool.workers[0]);
+
+    // If we couldn't start a thread, its jobs were stolen by the ones we did.
+    size_t failed = pool.workers[0].failed;
+    for (int i = 1; i < started; i++) {
+        join_thread(pool.workers[i].thread);
+        failed += pool.workers[i].failed;
+    }
+    for (int i = 0; i < nthreads; i++) {
+        mutex_destroy(&pool.deques[i].lock);
+    }
+    free(pool.deques);
+    free(pool.workers);
+    return failed;
+}
+
+size_t brainfuck_run_jobs(brainfuck_job *jobs, size_t njobs, int optlevel, int nthreads)
+{
+    return run_pool(jobs, njobs, NULL, optlevel, nthreads);
+}
+
+size_t brainfuck_run_batch(brainfuck_program *program, brainfuck_job *jobs, size_t njobs, int nthreads)
+{
+    return run_pool(jobs, njobs, program, 0, nthreads);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2019 easyaspi314
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ */
+
+/// brainfuck-profile.h: -DPROFILE loop counters and the report.
+///
+/// Every '[' in the source is a site with a 64-bit counter. A loop counts each time its
+/// body starts, so the count is its number of iterations. A loop the compiler turned
+/// into a clear, copy/multiply or scan counts each time it runs instead. The backends
+/// bump io->profile_counts[site] inline, each run adds its counts to the program when it
+/// is done, and brainfuck_free() prints the busiest sites to stderr.
+#ifndef BRAINFUCK_PROFILE_H
+#define BRAINFUCK_PROFILE_H
+
+#ifndef BRAINFUCK_JIT_C
+#   error "This file is only to be included from brainfuck-jit.c"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#   include <intrin.h>
+#endif
+
+// How many sites the report lists.
+#ifndef PROFILE_TOP
+#   define PROFILE_TOP 20
+#endif
+
+// Gives every op with a site its own counter, in program order, and records where it
+// came from. Returns false if we are out of memory.
+static bool number_profile_sites(brainfuck_program *restrict program)
+{
+    size_t sites = 0;
+    for (size_t i = 0; i < program->opcodes_len; i++) {
+        if (program->opcodes[i].site != 0) {
+            ++sites;
+        }
+    }
+    program->profile_sites = (bf_profile_site *)calloc(sites + 1, sizeof(bf_profile_site));
+    if (program->profile_sites == NULL) {
+        return false;
+    }
+    program->profile_sites_len = sites;
+    sites = 0;
+    for (size_t i = 0; i < program->opcodes_len; i++) {
+        bf_opcode *op = &program->opcodes[i];
+        if (op->site != 0) {
+            program->profile_sites[sites].source = op->site - 1;
+            program->profile_sites[sites].op = op->op;
+            op->site = (uint32_t)++sites;
+        }
+    }
+    bf_log("profile: %zu sites\n", sites);
+    return true;
+}
+
+// Gives a run its own counters. Returns false if we are out of memory.
+static bool start_profile(const brainfuck_program *restrict program, bf_io *restrict io)
+{
+    io->profile_counts = (uint64_t *)calloc(program->profile_sites_len + 1, sizeof(uint64_t));
+    return io->profile_counts != NULL;
+}
+
+// Adds a finished run's counts to the program. Runs can finish on several threads at
+// once.
+static void finish_profile(brainfuck_program *restrict program, bf_io *restrict io)
+{
+    for (size_t i = 0; i < program->profile_sites_len; i++) {
+        uint64_t count = io->profile_counts[i];
+        if (count == 0) {
+            continue;
+        }
+#if defined(_MSC_VER) && !defined(__clang__)
+        _InterlockedExchangeAdd64((volatile __int64 *)&program->profile_sites[i].count, (__int64)count);
+#else
+        __atomic_fetch_add(&program->profile_sites[i].count, count, __ATOMIC_RELAXED);
+#endif
+    }
+    free(io->profile_counts);
+    io->profile_counts = NULL;
+}
+
+static const char *profile_kind(int op)
+{
+    switch (op) {
+    case bf_opcode_start:
+        return "loop";
+    case bf_opcode_clear:
+        return "clear";
+    case bf_opcode_copy_mul:
+        return "copy/mul";
+    case bf_opcode_scan:
+        return "scan";
+    default:
+        return "?";
+    }
+}
+
+// Busiest first, then in source order.
+static int compare_profile_sites(const void *a, const void *b)
+{
+    const bf_profile_site *x = (const bf_profile_site *)a;
+    const bf_profile_site *y = (const bf_profile_site *)b;
+    if (x->count != y->count) {
+        return x->count < y->count ? 1 : -1;
+    }
+    return x->source < y->source ? -1 : x->source > y->source;
+}
+
+// Prints the PROFILE_TOP busiest sites to stderr. The sites are sorted in place, so
+// this is the last thing done with them.
+static void print_profile(brainfuck_program *restrict program)
+{
+    bf_profile_site *sites = program->profile_sites;
+    size_t len = program->profile_sites_len;
+    if (sites == NULL) {
+        return;
+    }
+    uint64_t total = 0;
+    for (size_t i = 0; i < len; i++) {
+        total += sites[i].count;
+    }
+    qsort(sites, len, sizeof(bf_profile_site), &compare_profile_sites);
+    fflush(stdout);
+    fprintf(stderr, "profile: %zu loops, %llu counted\n", len, (unsigned long long)total);
+    if (total == 0) {
+        return;
+    }
+    fprintf(stderr, "%6s %20s %7s %10s  %s\n", "rank", "count", "%", "offset", "kind");
+    for (size_t i = 0; i < len && i < PROFILE_TOP && sites[i].count != 0; i++) {
+        fprintf(stderr, "%6zu %20llu %6.2f%% %10u  %s\n", i + 1, (unsigned long long)sites[i].count,
+                100.0 * (double)sites[i].count / (double)total, sites[i].source, profile_kind(sites[i].op));
+    }
+}
+
+#endif // BRAINFUCK_PROFILE_H
@@ -1,52 +1,319 @@
+
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
+#include <sys/resource.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include "brainfuck-jit.h"
 
+// Reads a whole file into a NUL terminated buffer. Returns NULL on error.
+static char *read_file(const char *path, size_t *len_out)
+{
+    // Easier to use unistd instead of stdio
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Could not open %s\n", path);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        printf("Error statting %s\n", path);
+        close(fd);
+        return NULL;
+    }
+    off_t len = st.st_size;
+    char *buf = (char *)malloc(len + 1);
+    if (!buf) {
+        puts("Out of memory");
+        close(fd);
+        return NULL;
+    }
+    if (read(fd, buf, len) < len) {
+        printf("Couldn't read %s\n", path);
+        close(fd);
+        free(buf);
+        return NULL;
+    }
+    close(fd);
+    buf[len] = '\0';
+    *len_out = len;
+    return buf;
+}
+
+// Runs every program in a manifest on a thread pool.
+//
+// Each line of the manifest is "program [input [output]]". Jobs without an output file
+// are written to stdout in manifest order.
+static int run_manifest(const char *path, int optlevel, int nthreads)
+{
+    size_t len;
+    char *manifest = read_file(path, &len);
+    if (!manifest) {
+        return 1;
+    }
+    size_t nlines = 1;
+    for (size_t i = 0; i < len; i++) {
+        nlines += manifest[i] == '\n';
+    }
+    brainfuck_job *jobs = (brainfuck_job *)calloc(nlines, sizeof(brainfuck_job));
+    char **outputs = (char **)calloc(nlines, sizeof(char *));
+    // Where each job came from, for the errors.
+    char **programs = (char **)calloc(nlines, sizeof(char *));
+    size_t *line_numbers = (size_t *)calloc(nlines, sizeof(size_t));
+    if (!jobs || !outputs || !programs || !line_numbers) {
+        puts("Out of memory");
+        free(manifest);
+        free(jobs);
+        free(outputs);
+        free(programs);
+        free(line_numbers);
+        return 1;
+    }
+
+    int ret = 0;
+    size_t njobs = 0, line_number = 0;
+    char *next = NULL;
+    for (char *line = manifest; line; line = next) {
+        next = strchr(line, '\n');
+        if (next) {
+            *next++ = '\0';
+        }
+        ++line_number;
+        char *fields[3] = { NULL, NULL, NULL };
+        char *save_field = NULL;
+        for (int i = 0; i < 3; i++) {
+            fields[i] = strtok_r(i == 0 ? line : NULL, " \t\r", &save_field);
+        }
+        if (!fields[0] || fields[0][0] == '#') {
+            continue;
+        }
+        brainfuck_job *job = &jobs[njobs];
+        char *code = read_file(fields[0], &job->len);
+        char *input = NULL;
+        if (!code || (fields[1] && !(input = read_file(fields[1], &job->input_len)))) {
+            free(code);
+            ret = 1;
+            goto done;
+        }
+        job->code = code;
+        job->input = input;
+        outputs[njobs] = fields[2];
+        programs[njobs] = fields[0];
+        line_numbers[njobs] = line_number;
+        ++njobs;
+    }
+
+    if (brainfuck_run_jobs(jobs, njobs, optlevel, nthreads) != 0) {
+        ret = 1;
+    }
+
+    for (size_t i = 0; i < njobs; i++) {
+        // A failed job still gets what it wrote before it failed.
+        if (jobs[i].status != 0) {
+            const char *reason = jobs[i].status == -2 ? "ran off the tape"
+                               : jobs[i].status == -3 ? "didn't compile"
+                               : "out of memory";
+            fprintf(stderr, "line %zu (%s): %s\n", line_numbers[i], programs[i], reason);
+        }
+        if (outputs[i]) {
+            FILE *f = fopen(outputs[i], "wb");
+            if (!f) {
+                printf("Could not open %s\n", outputs[i]);
+                ret = 1;
+                continue;
+            }
+            fwrite(jobs[i].output, 1, jobs[i].output_len, f);
+            fclose(f);
+        } else {
+            fwrite(jobs[i].output, 1, jobs[i].output_len, stdout);
+        }
+    }
+
+done:
+    for (size_t i = 0; i < njobs; i++) {
+        free((char *)jobs[i].code);
+        free((char *)jobs[i].input);
+        free(jobs[i].output);
+    }
+    free(jobs);
+    free(outputs);
+    free(programs);
+    free(line_numbers);
+    free(manifest);
+    return ret;
+}
+
+// Compiles one program and runs it over every line of a records file on a thread pool.
+// Each record is passed as input including its newline, and the outputs are printed in
+// record order.
+static int run_records(const char *program_path, const char *records_path, int optlevel, int nthreads)
+{
+    size_t len, records_len;
+    char *code = read_file(program_path, &len);
+    if (!code) {
+        return 1;
+    }
+    char *records = read_file(records_path, &records_len);
+    if (!records) {
+        free(code);
+        return 1;
+    }
+    brainfuck_program *program = brainfuck_compile(code, len, optlevel);
+    free(code);
+    if (!program) {
+        free(records);
+        return 1;
+    }
+
+    size_t nrecords = 0;
+    for (size_t i = 0; i < records_len; i++) {
+        nrecords += records[i] == '\n' || i == records_len - 1;
+    }
+    brainfuck_job *jobs = (brainfuck_job *)calloc(nrecords ? nrecords : 1, sizeof(brainfuck_job));
+    if (!jobs) {
+        puts("Out of memory");
+        brainfuck_free(program);
+        free(records);
+        return 1;
+    }
+    size_t start = 0, njobs = 0;
+    for (size_t i = 0; i < records_len; i++) {
+        if (records[i] == '\n' || i == records_len - 1) {
+            jobs[njobs].input = records + start;
+            jobs[njobs].input_len = i + 1 - start;
+            ++njobs;
+            start = i + 1;
+        }
+    }
+
+    int ret = brainfuck_run_batch(program, jobs, njobs, nthreads) != 0;
+    for (size_t i = 0; i < njobs; i++) {
+        fwrite(jobs[i].output, 1, jobs[i].output_len, stdout);
+        free(jobs[i].output);
+    }
+    free(jobs);
+    brainfuck_free(program);
+    free(records);
+    return ret;
+}
+
+// MB/s of source, or - if it was too quick to tell.
+static void print_phase(const char *name, double seconds, size_t len)
+{
+    if (seconds > 0) {
+        printf("%-9s %10.2f ms %10.1f MB/s\n", name, seconds * 1e3, (double)len / 1e6 / seconds);
+    } else {
+        printf("%-9s %10.2f ms %10s MB/s\n", name, seconds * 1e3, "-");
+    }
+}
+
+// -t: Compiles the program, and prints how long each phase took and how much memory it
+// needed.
+static int time_compile(const char *path, int optlevel)
+{
+    size_t len;
+    char *buf = read_file(path, &len);
+    if (!buf) {
+        return 1;
+    }
+    brainfuck_program *program = brainfuck_compile(buf, len, optlevel);
+    free(buf);
+    if (!program) {
+        return 1;
+    }
+    brainfuck_compile_stats stats;
+    brainfuck_get_compile_stats(program, &stats);
+    brainfuck_free(program);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    long peak_kib = (long)(usage.ru_maxrss / 1024);
+#else
+    long peak_kib = (long)usage.ru_maxrss;
+#endif
+    printf("source    %10zu bytes\n", stats.source_len);
+    printf("ops       %10zu\n", stats.opcodes_len);
+    printf("code      %10zu bytes\n", stats.code_size);
+    print_phase("parse", stats.parse_time, stats.source_len);
+    print_phase("optimize", stats.optimize_time, stats.source_len);
+    print_phase("codegen", stats.codegen_time, stats.source_len);
+    print_phase("total", stats.parse_time + stats.optimize_time + stats.codegen_time, stats.source_len);
+    printf("peak RSS  %10ld KiB\n", peak_kib);
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
     int optlevel = 2;
-    if (argc > 1 && argv[1][0] == '-' && argv[1][1] == 'O') {
-        optlevel = argv[1][2] - '0';
+    int nthreads = 0;
+    const char *manifest = NULL;
+    const char *records = NULL;
+    // -c: Compile the program and stop, for timing the compiler. -t: Same, but print
+    // how long it took.
+    int compile_only = 0;
+    int time_only = 0;
+    // Opt-in code cache
+    if (getenv("BRAINFUCK_CACHE_DIR")) {
+        brainfuck_set_cache_dir(getenv("BRAINFUCK_CACHE_DIR"));
+    }
+    // Opt-in perf support: BRAINFUCK_PERF=map, jitdump, or map,jitdump
+    if (getenv("BRAINFUCK_PERF")) {
+        const char *perf = getenv("BRAINFUCK_PERF");
+        brainfuck_set_perf_map((strstr(perf, "map") ? BRAINFUCK_PERF_MAP : 0)
+                             | (strstr(perf, "jitdump") ? BRAINFUCK_PERF_JITDUMP : 0));
+    }
+    while (argc > 1 && argv[1][0] == '-') {
+        if (argv[1][1] == 'O') {
+            optlevel = argv[1][2] - '0';
+        } else if (argv[1][1] == 'c') {
+            compile_only = 1;
+        } else if (argv[1][1] == 't') {
+            time_only = 1;
+        } else if (argv[1][1] == 'j') {
+            nthreads = atoi(argv[1] + 2);
+        } else if (argv[1][1] == 'm' && argc > 2) {
+            manifest = argv[2];
+            ++argv;
+            --argc;
+        } else if (argv[1][1] == 'b' && argc > 2) {
+            records = argv[2];
+            ++argv;
+            --argc;
+        } else {
+            break;
+        }
         ++argv;
         --argc;
     }
 
-    if (argc == 1) {
+    if (manifest) {
+        return run_manifest(manifest, optlevel, nthreads);
+    } else if (time_only && argc > 1) {
+        return time_compile(argv[1], optlevel);
+    } else if (records && argc > 1) {
+        return run_records(argv[1], records, optlevel, nthreads);
+    } else if (argc == 1) {
         const char test[] = ">++[<+++++++++++++>-]<[[>+>+<<-]>[<+>-]++++++++[>++++++++<-]>.[-]<<>++++++++++[>++++++++++[>++++++++++[>++++++++++[>++++++++++[>++++++++++[>++++++++++[-]<-]<-]<-]<-]<-]<-]<-]++++++++++.";
         brainfuck(test, sizeof(test), optlevel);
     } else {
-        // Easier to use unistd instead of stdio
-        int fd = open(argv[1], O_RDONLY);
-        if (fd < 0) {
-            printf("Could not open %s\n", argv[1]);
-            return 1;
-        }
-        struct stat st;
-        if (fstat(fd, &st) < 0) {
-            printf("Error statting %s\n", argv[1]);
-            close(fd);
-            return 1;
-        }
-        off_t len = st.st_size;
-        char *buf = (char *)malloc(len + 1);
+        size_t len;
+        char *buf = read_file(argv[1], &len);
         if (!buf) {
-            puts("Out of memory");
-            close(fd);
             return 1;
         }
-        if (read(fd, buf, len) < len) {
-            printf("Couldn't read %s\n", argv[1]);
-            close(fd);
+        if (compile_only) {
+            brainfuck_program *program = brainfuck_compile(buf, len, optlevel);
             free(buf);
-            return 1;
+            if (!program) {
+                return 1;
+            }
+            brainfuck_free(program);
+            return 0;
         }
-        close(fd);
-        buf[len] = '\0';
         brainfuck(buf, len, optlevel);
         free(buf);
     }
 }
-
@@ -0,0 +1,63 @@
+#!/bin/sh
+# Tests that checked builds stop a program right where it runs off the tape.
+#
+#   tests/checked.sh        (or make check)
+#
+# Builds brainfuck-jit, brainfuck-interp and bf2c with CHECKED=1 in a scratch copy of the
+# tree, and runs each program below on every one of them at -O0, -O1 and -O2. A program
+# has to print exactly what it would have printed before leaving the tape, and exit with
+# 1 if it does leave it.
+
+OPTS=${OPTS:-"0 1 2"}
+CC=${CC:-cc}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT INT TERM
+
+cp "$ROOT"/*.c "$ROOT"/*.h "$ROOT"/Makefile "$TMP/"
+make -s -C "$TMP" CHECKED=1 brainfuck-jit brainfuck-interp bf2c || exit 1
+
+failed=0
+
+# expect program output status
+expect() {
+    printf '%s' "$1" > "$TMP/prog.b"
+    for b in jit interp bf2c; do
+        for o in $OPTS; do
+            case $b in
+            bf2c)
+                "$TMP/bf2c" -O"$o" "$TMP/prog.b" > "$TMP/prog.c" && $CC -O1 -w "$TMP/prog.c" -o "$TMP/prog" || exit 1
+                "$TMP/prog" < /dev/null > "$TMP/out" 2> /dev/null
+                ;;
+            *)
+                "$TMP/brainfuck-$b" -O"$o" "$TMP/prog.b" < /dev/null > "$TMP/out" 2> /dev/null
+                ;;
+            esac
+            status=$?
+            if [ "$(cat "$TMP/out")" != "$2" ] || [ "$status" -ne "$3" ]; then
+                printf 'FAIL %-7s -O%s %s: printed "%s" and exited with %d, expected "%s" and %d\n' \
+                    "$b" "$o" "$1" "$(cat "$TMP/out")" "$status" "$2" "$3"
+                failed=$((failed + 1))
+            fi
+        done
+    done
+}
+
+# The first loop never runs, so it can't run off the tape.
+expect '[<+>]++++++++[>++++++<-]>.[>]' 0 0
+# The 0 goes out before the program leaves the tape.
+expect '++++++++[>++++++<-]>.<<<<<<<<+[>]' 0 1
+# Cells below 0 are off the tape, whether or not we can tell which cells a program uses.
+expect '<<<+.' '' 1
+expect '<<<+.>>>>[>]' '' 1
+# A copy loop whose source is 0 doesn't touch its targets, so it can't run off the tape
+# either, and the one after it only does once it has printed.
+expect '[-<<+>>]>>>[+]' '' 0
+expect '++++++++[>++++++<-]>.[-<<+>>]' 0 1
+
+if [ "$failed" -ne 0 ]; then
+    echo "$failed failed"
+    exit 1
+fi
+echo "All passed"